@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include <raylib.h>
+#include <raymath.h>
+
+#include "game.h"
+#include "compact.h"
+
+// Runs many seeded games at once with a simple bot, for balancing sweeps and soak tests
+// usage: batch [games] [threads] [seed] [compact]
+// With compact set to 1, every game is also run with its objects going through their compact state every tick,
+// and the results and sizes of both runs are compared (exits with a failure if a delta doesn't decode)
+
+#define BATCH_GAMES 200
+#define BATCH_TICK (1.0/60) // Fixed delta time of every tick
+#define BATCH_MAX_TIME 300.0 // Simulated seconds before a game is stopped
+#define BOT_AIM_TOLERANCE 0.1 // Angle in radians the bot considers aimed
+
+typedef struct {
+	int level; // Level reached
+	long ticks;
+	bool lost;
+
+	// Compact state, summed over all ticks
+	long objects;
+	long objectBytes; // Size of the objects in memory
+	long deltaBytes;
+	long deltaErrors; // Deltas that didn't decode to the state they were encoded from
+} GameResult;
+
+atomic_int nextGame;
+int gameCount;
+uint64_t baseSeed;
+bool compact;
+GameResult* results;
+GameResult* compactResults;
+
+// Flies towards the closest enemy base while shooting
+GameInput BotInput(GameContext* ctx) {
+	Object* player = ctx->player;
+
+	Object* target = NULL;
+	float targetDist = 0;
+	for (Node* node = ctx->objs_head; node != NULL; node = node->next) {
+		if (node->obj->type != TYPE_BASE) continue;
+
+		float dist = Vector2Distance(player->pos, node->obj->pos);
+		if (target && dist >= targetDist) continue;
+
+		target = node->obj;
+		targetDist = dist;
+	}
+
+	GameInput input = {.thrust = 1, .shoot = true};
+	if (!target) return input;
+
+	// Turning the shortest way towards the target
+	float angle = Vector2Angle((Vector2){0, -1}, Vector2Subtract(target->pos, player->pos));
+	float diff = Wrap(angle - player->rot, -PI, PI);
+	if (diff >  BOT_AIM_TOLERANCE) input.turn =  1;
+	if (diff < -BOT_AIM_TOLERANCE) input.turn = -1;
+
+	return input;
+}
+
+// Quantizes the objects of the list starting at head, adding up the size they take in memory
+void QuantizeList(Node* head, GameResult* result) {
+	for (Node* node = head; node != NULL; node = node->next) {
+		Object* obj = node->obj;
+
+		result->objectBytes += sizeof(Node) + sizeof(Object) + obj->vertCount * sizeof(Vector2) * (obj->transVerts? 2 : 1);
+
+		CompactObject packed = PackObject(obj, BATCH_TICK);
+		UnpackObject(&packed, obj, BATCH_TICK);
+	}
+}
+
+// Sends the game through its compact state, as if it was synced to another machine every tick
+void CompactTick(GameContext* ctx, CompactState states[2], CompactState* decoded, CompactDelta* delta, GameResult* result) {
+	CompactState* prev = &states[result->ticks % 2];
+	CompactState* curr = &states[(result->ticks + 1) % 2];
+
+	PackGame(curr, ctx, BATCH_TICK);
+	EncodeDelta(delta, prev, curr);
+
+	result->objects += curr->count;
+	result->deltaBytes += delta->size;
+
+	// Checking the delta brings prev to curr (then there is nothing left to encode between them but the header)
+	if (!DecodeDelta(decoded, prev, delta)) ++result->deltaErrors;
+	else {
+		EncodeDelta(delta, decoded, curr);
+		if (delta->size != 1 || decoded->tick != curr->tick) ++result->deltaErrors;
+	}
+
+	// Continuing the game from the quantized state
+	QuantizeList(ctx->objs_head, result);
+	for (int i = 0; i < SECTORS_X * SECTORS_Y; ++i) QuantizeList(ctx->sectors.sectors[i].head, result);
+}
+
+GameResult RunGame(uint64_t seed, bool quantize) {
+	GameContext ctx;
+	InitGame(&ctx, seed);
+
+	CompactState states[2] = {0};
+	CompactState decoded = {0};
+	CompactDelta delta = {0};
+
+	// Leaving the main menu
+	Process(&ctx, (GameInput){.play = true}, BATCH_TICK);
+
+	GameResult result = {0};
+	while (ctx.player && ctx.simTime < BATCH_MAX_TIME) {
+		if (quantize) CompactTick(&ctx, states, &decoded, &delta, &result);
+
+		Process(&ctx, BotInput(&ctx), BATCH_TICK);
+		++result.ticks;
+	}
+
+	FreeCompactState(&states[0]);
+	FreeCompactState(&states[1]);
+	FreeCompactState(&decoded);
+	FreeCompactDelta(&delta);
+
+	// Losing sends the level back to 0, but it is kept as the highscore
+	result.lost = ctx.player == NULL;
+	result.level = result.lost? ctx.highscore : ctx.level;
+
+	FreeGame(&ctx);
+	return result;
+}
+
+void* Worker(void* arg) {
+	int game;
+	while ((game = atomic_fetch_add(&nextGame, 1)) < gameCount) {
+		results[game] = RunGame(baseSeed + game, false);
+		if (compact) compactResults[game] = RunGame(baseSeed + game, true);
+	}
+
+	return NULL;
+}
+
+double Now() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+	gameCount = argc > 1? atoi(argv[1]) : BATCH_GAMES;
+	int threadCount = argc > 2? atoi(argv[2]) : sysconf(_SC_NPROCESSORS_ONLN);
+	baseSeed = argc > 3? strtoull(argv[3], NULL, 10) : 1;
+	compact = argc > 4 && atoi(argv[4]);
+	if (gameCount < 1 || threadCount < 1) {
+		fprintf(stderr, "usage: %s [games] [threads] [seed] [compact]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	results = malloc(gameCount * sizeof(GameResult));
+	compactResults = compact? malloc(gameCount * sizeof(GameResult)) : NULL;
+	pthread_t* threads = malloc(threadCount * sizeof(pthread_t));
+
+	// Running the games
+	double start = Now();
+	for (int i = 0; i < threadCount; ++i) pthread_create(&threads[i], NULL, Worker, NULL);
+	for (int i = 0; i < threadCount; ++i) pthread_join(threads[i], NULL);
+	double elapsed = Now() - start;
+
+	// Aggregating
+	long ticks = 0;
+	int lost = 0;
+	int maxLevel = 0;
+	double levelSum = 0;
+	for (int i = 0; i < gameCount; ++i) {
+		ticks += results[i].ticks;
+		lost += results[i].lost;
+		levelSum += results[i].level;
+		if (results[i].level > maxLevel) maxLevel = results[i].level;
+	}
+
+	printf("games: %d, threads: %d, seeds: %llu-%llu\n", gameCount, threadCount, (unsigned long long)baseSeed, (unsigned long long)(baseSeed + gameCount - 1));
+	printf("time: %.2fs, %.1f games/s, %.0f ticks/s\n", elapsed, gameCount / elapsed, ticks / elapsed);
+	printf("level: %.2f mean, %d max, %d/%d games lost\n", levelSum / gameCount, maxLevel, lost, gameCount);
+
+	// Comparing with the quantized games
+	bool failed = false;
+	if (compact) {
+		long objects = 0, objectBytes = 0, deltaBytes = 0, deltaErrors = 0, compactTicks = 0;
+		int compactLost = 0, compactMaxLevel = 0, sameLevel = 0;
+		double compactLevelSum = 0;
+		for (int i = 0; i < gameCount; ++i) {
+			objects += compactResults[i].objects;
+			objectBytes += compactResults[i].objectBytes;
+			deltaBytes += compactResults[i].deltaBytes;
+			deltaErrors += compactResults[i].deltaErrors;
+			compactTicks += compactResults[i].ticks;
+
+			compactLost += compactResults[i].lost;
+			compactLevelSum += compactResults[i].level;
+			if (compactResults[i].level > compactMaxLevel) compactMaxLevel = compactResults[i].level;
+			sameLevel += compactResults[i].level == results[i].level;
+		}
+
+		printf("compact level: %.2f mean, %d max, %d/%d games lost, %d/%d games reached the same level\n",
+			compactLevelSum / gameCount, compactMaxLevel, compactLost, gameCount, sameLevel, gameCount);
+		printf("bytes per object: %zu compact, %.1f in memory (%zu object, %zu node, vertices)\n",
+			sizeof(CompactObject), (double)objectBytes / objects, sizeof(Object), sizeof(Node));
+		printf("bytes per tick: %.1f delta, %.1f compact, %.1f in memory (%.1f objects), %ld bad deltas\n",
+			(double)deltaBytes / compactTicks, (double)objects * sizeof(CompactObject) / compactTicks,
+			(double)objectBytes / compactTicks, (double)objects / compactTicks, deltaErrors);
+		failed = deltaErrors > 0;
+	}
+
+	free(threads);
+	free(results);
+	free(compactResults);
+	return failed? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
@@ -0,0 +1,374 @@
+#include <stdlib.h>
+#include <math.h>
+
+#include "compact.h"
+
+#define COMPACT_MAX_RECORD 48 // Largest encoded record (id, fields, and the varints of the other fields)
+
+// Colors objects can have
+static const Color palette[] = {WHITE, GRAY, RED, LIGHTGRAY, ORANGE, YELLOW};
+#define PALETTE_SIZE (int)(sizeof(palette) / sizeof(palette[0]))
+
+// returns: value rounded to the nearest integer (inlined, unlike lroundf)
+static int64_t RoundToInt(float value) {
+	return value + (value < 0? -0.5f : 0.5f);
+}
+
+// returns: value multiplied by scale, rounded and clamped between min and max
+static int32_t Quantize(float value, float scale, int32_t min, int32_t max) {
+	float scaled = value * scale;
+	if (scaled < min) return min;
+	if (scaled > max) return max;
+	return RoundToInt(scaled);
+}
+
+// returns: position quantized and wrapped into [0, range)
+static uint32_t QuantizePos(float pos, int64_t range) {
+	int64_t steps = RoundToInt((pos + COMPACT_MARGIN) * COMPACT_POS_SCALE) % range;
+	return steps < 0? steps + range : steps;
+}
+
+// returns: ticks of tickTime until an object with lifetime is destroyed by Process
+static uint16_t LifetimeTicks(float lifetime, float tickTime) {
+	double ticks = lifetime / (double)tickTime;
+	if (ticks < 0) return 0;
+	if (ticks >= COMPACT_NO_LIFETIME - 1) return COMPACT_NO_LIFETIME - 1;
+
+	// Close to a whole number of ticks, the rounding of each subtraction decides which tick it is, so they are repeated
+	if (fabs(ticks - round(ticks)) < COMPACT_LIFETIME_EPSILON) {
+		uint16_t count = 1;
+		while ((lifetime -= tickTime) >= 0 && count < COMPACT_NO_LIFETIME - 1) ++count;
+		return count;
+	}
+
+	return (uint16_t)ticks + 1;
+}
+
+// returns: index of color in the palette, 0 if it isn't there
+static uint8_t PaletteIndex(Color color) {
+	for (int i = 0; i < PALETTE_SIZE; ++i) {
+		if (palette[i].r == color.r && palette[i].g == color.g && palette[i].b == color.b && palette[i].a == color.a) return i;
+	}
+
+	return 0;
+}
+
+CompactObject PackObject(Object* obj, float tickTime) {
+	return (CompactObject){
+		.id = obj->id,
+
+		.x = QuantizePos(obj->pos.x, COMPACT_POS_RANGE_X),
+		.y = QuantizePos(obj->pos.y, COMPACT_POS_RANGE_Y),
+		.velX = Quantize(obj->vel.x, COMPACT_VEL_SCALE, INT16_MIN, INT16_MAX),
+		.velY = Quantize(obj->vel.y, COMPACT_VEL_SCALE, INT16_MIN, INT16_MAX),
+
+		.rot = (uint16_t)RoundToInt(obj->rot * COMPACT_ROT_SCALE), // A full turn is 65536 steps, so keeping the low 16 bits wraps it
+		.spin = Quantize(obj->spin, COMPACT_SPIN_SCALE, INT16_MIN, INT16_MAX),
+
+		.lifetime = obj->lifetime == NO_LIFETIME? COMPACT_NO_LIFETIME : LifetimeTicks(obj->lifetime, tickTime),
+
+		.health = obj->health < INT8_MIN? INT8_MIN : obj->health > INT8_MAX? INT8_MAX : obj->health,
+		.maxHealth = obj->maxHealth > UINT8_MAX? UINT8_MAX : obj->maxHealth,
+
+		.radius = obj->radius > UINT8_MAX? UINT8_MAX : obj->radius,
+		.vertCount = obj->vertCount,
+		.type = obj->type,
+		.layer = obj->layer,
+		.layerMask = obj->layerMask,
+		.color = PaletteIndex(obj->color),
+	};
+}
+
+void UnpackObject(CompactObject* compact, Object* obj, float tickTime) {
+	obj->id = compact->id;
+
+	obj->pos.x = compact->x / (double)COMPACT_POS_SCALE - COMPACT_MARGIN;
+	obj->pos.y = compact->y / (double)COMPACT_POS_SCALE - COMPACT_MARGIN;
+	obj->vel.x = compact->velX / COMPACT_VEL_SCALE;
+	obj->vel.y = compact->velY / COMPACT_VEL_SCALE;
+
+	obj->rot = compact->rot / COMPACT_ROT_SCALE;
+	obj->spin = compact->spin / COMPACT_SPIN_SCALE;
+
+	// Half a tick short of the count, so it goes below zero on the last of its ticks
+	obj->lifetime = compact->lifetime == COMPACT_NO_LIFETIME? NO_LIFETIME : (compact->lifetime - 0.5f) * tickTime;
+
+	obj->health = compact->health;
+	obj->maxHealth = compact->maxHealth;
+
+	obj->radius = compact->radius;
+	obj->type = compact->type;
+	obj->layer = compact->layer;
+	obj->layerMask = compact->layerMask;
+	obj->color = palette[compact->color < PALETTE_SIZE? compact->color : 0];
+}
+
+// returns: tick of tickTime that time is at
+static uint32_t TickAt(double time, float tickTime) {
+	return llround(time / tickTime);
+}
+
+// Adds the objects of the list starting at head to the state
+static void PackList(CompactState* state, Node* head, uint32_t sleepTick, float tickTime) {
+	for (Node* node = head; node != NULL; node = node->next) {
+		if (state->count == state->capacity) {
+			state->capacity = state->capacity? state->capacity * 2 : 64;
+			state->objects = realloc(state->objects, state->capacity * sizeof(CompactObject));
+		}
+
+		CompactObject packed = PackObject(node->obj, tickTime);
+		packed.sleepTick = sleepTick;
+		state->objects[state->count++] = packed;
+	}
+}
+
+static int CompareIds(const void* a, const void* b) {
+	uint32_t idA = ((CompactObject*)a)->id;
+	uint32_t idB = ((CompactObject*)b)->id;
+	return (idA > idB) - (idA < idB);
+}
+
+void PackGame(CompactState* state, GameContext* ctx, float tickTime) {
+	state->tick = TickAt(ctx->simTime, tickTime);
+	state->count = 0;
+
+	PackList(state, ctx->objs_head, 0, tickTime);
+	for (int i = 0; ctx->sectors.sectors && i < SECTORS_X * SECTORS_Y; ++i) {
+		Sector* sector = &ctx->sectors.sectors[i];
+		if (sector->head) PackList(state, sector->head, TickAt(sector->sleepTime, tickTime) + 1, tickTime);
+	}
+
+	qsort(state->objects, state->count, sizeof(CompactObject), CompareIds);
+}
+
+void FreeCompactState(CompactState* state) {
+	free(state->objects);
+	*state = (CompactState){0};
+}
+
+// - Encoding -
+// Unsigned LEB128, 7 bits per byte
+static void WriteVarint(CompactDelta* delta, uint32_t value) {
+	while (value >= 0x80) {
+		delta->data[delta->size++] = value | 0x80;
+		value >>= 7;
+	}
+	delta->data[delta->size++] = value;
+}
+
+// Writes the difference between two 16 bit fields, wrapped so crossing a full turn is a small step
+static void WriteDiff(CompactDelta* delta, uint16_t prev, uint16_t curr) {
+	int16_t diff = (uint16_t)(curr - prev);
+	WriteVarint(delta, (uint16_t)(((uint16_t)diff << 1) ^ (uint16_t)(diff >> 15))); // Zigzag, so small negative differences are small too
+}
+
+// Writes the difference between two 32 bit fields (positions and ticks)
+static void WriteDiff32(CompactDelta* delta, uint32_t prev, uint32_t curr) {
+	int32_t diff = curr - prev;
+	WriteVarint(delta, ((uint32_t)diff << 1) ^ (uint32_t)(diff >> 31));
+}
+
+// returns: fields of curr that differ from prev
+static uint16_t ChangedFields(CompactObject* prev, CompactObject* curr) {
+	uint16_t fields = 0;
+
+	if (curr->x != prev->x || curr->y != prev->y) fields |= COMPACT_POS;
+	if (curr->velX != prev->velX || curr->velY != prev->velY) fields |= COMPACT_VEL;
+	if (curr->rot != prev->rot) fields |= COMPACT_ROT;
+	if (curr->spin != prev->spin) fields |= COMPACT_SPIN;
+	if (curr->lifetime != prev->lifetime) fields |= COMPACT_LIFETIME;
+	if (curr->health != prev->health || curr->maxHealth != prev->maxHealth) fields |= COMPACT_HEALTH;
+	if (curr->radius != prev->radius || curr->vertCount != prev->vertCount || curr->type != prev->type
+		|| curr->layer != prev->layer || curr->layerMask != prev->layerMask || curr->color != prev->color) fields |= COMPACT_STATIC;
+	if (curr->sleepTick != prev->sleepTick) fields |= COMPACT_SLEEP;
+
+	return fields;
+}
+
+// Makes room for a record (or the header) at the end of delta
+static void ReserveRecord(CompactDelta* delta) {
+	if (delta->size + COMPACT_MAX_RECORD > delta->capacity) {
+		delta->capacity = delta->capacity? delta->capacity * 2 : 1024;
+		delta->data = realloc(delta->data, delta->capacity);
+	}
+}
+
+static void WriteRecord(CompactDelta* delta, uint32_t* lastId, uint32_t id, uint16_t fields, CompactObject* prev, CompactObject* curr) {
+	ReserveRecord(delta);
+
+	// Ids are increasing, so only the gap from the last record is written
+	WriteVarint(delta, id - *lastId);
+	*lastId = id;
+	WriteVarint(delta, fields);
+
+	if (fields & COMPACT_POS) {
+		WriteDiff32(delta, prev->x, curr->x);
+		WriteDiff32(delta, prev->y, curr->y);
+	}
+	if (fields & COMPACT_VEL) {
+		WriteDiff(delta, prev->velX, curr->velX);
+		WriteDiff(delta, prev->velY, curr->velY);
+	}
+	if (fields & COMPACT_ROT) WriteDiff(delta, prev->rot, curr->rot);
+	if (fields & COMPACT_SPIN) WriteDiff(delta, prev->spin, curr->spin);
+	if (fields & COMPACT_LIFETIME) WriteDiff(delta, prev->lifetime, curr->lifetime);
+	if (fields & COMPACT_HEALTH) {
+		delta->data[delta->size++] = curr->health;
+		delta->data[delta->size++] = curr->maxHealth;
+	}
+	if (fields & COMPACT_STATIC) {
+		delta->data[delta->size++] = curr->radius;
+		delta->data[delta->size++] = curr->vertCount;
+		delta->data[delta->size++] = curr->type;
+		delta->data[delta->size++] = curr->layer;
+		delta->data[delta->size++] = curr->layerMask;
+		delta->data[delta->size++] = curr->color;
+	}
+	if (fields & COMPACT_SLEEP) WriteDiff32(delta, prev->sleepTick, curr->sleepTick);
+}
+
+void EncodeDelta(CompactDelta* delta, CompactState* prev, CompactState* curr) {
+	delta->size = 0;
+	uint32_t lastId = 0;
+
+	// Header, the tick the state moved by
+	ReserveRecord(delta);
+	WriteDiff32(delta, prev->tick, curr->tick);
+
+	// Going through both states in order of id
+	int p = 0, c = 0;
+	while (p < prev->count || c < curr->count) {
+		CompactObject* prevObj = p < prev->count? &prev->objects[p] : NULL;
+		CompactObject* currObj = c < curr->count? &curr->objects[c] : NULL;
+
+		// Removed
+		if (!currObj || (prevObj && prevObj->id < currObj->id)) {
+			WriteRecord(delta, &lastId, prevObj->id, COMPACT_REMOVED, prevObj, prevObj);
+			++p;
+			continue;
+		}
+
+		// Created (written as changes from an object with everything at 0)
+		if (!prevObj || currObj->id < prevObj->id) {
+			CompactObject empty = {.id = currObj->id};
+			WriteRecord(delta, &lastId, currObj->id, ChangedFields(&empty, currObj), &empty, currObj);
+			++c;
+			continue;
+		}
+
+		// Changed
+		uint16_t fields = ChangedFields(prevObj, currObj);
+		if (fields) WriteRecord(delta, &lastId, currObj->id, fields, prevObj, currObj);
+		++p;
+		++c;
+	}
+}
+
+// - Decoding -
+typedef struct {
+	uint8_t* data;
+	int size;
+	int pos;
+	bool failed;
+} Reader;
+
+static uint8_t ReadByte(Reader* reader) {
+	if (reader->pos >= reader->size) {
+		reader->failed = true;
+		return 0;
+	}
+
+	return reader->data[reader->pos++];
+}
+
+static uint32_t ReadVarint(Reader* reader) {
+	uint32_t value = 0;
+	for (int shift = 0; shift < 35; shift += 7) {
+		uint8_t byte = ReadByte(reader);
+		value |= (uint32_t)(byte & 0x7F) << shift;
+		if (!(byte & 0x80)) return value;
+	}
+
+	reader->failed = true;
+	return 0;
+}
+
+static uint32_t ReadDiff32(Reader* reader, uint32_t prev) {
+	uint32_t zigzag = ReadVarint(reader);
+	return prev + ((zigzag >> 1) ^ -(zigzag & 1));
+}
+
+static uint16_t ReadDiff(Reader* reader, uint16_t prev) {
+	uint16_t zigzag = ReadVarint(reader);
+	return prev + (uint16_t)(zigzag >> 1 ^ -(zigzag & 1));
+}
+
+static void AddObject(CompactState* state, CompactObject obj) {
+	if (state->count == state->capacity) {
+		state->capacity = state->capacity? state->capacity * 2 : 64;
+		state->objects = realloc(state->objects, state->capacity * sizeof(CompactObject));
+	}
+
+	state->objects[state->count++] = obj;
+}
+
+bool DecodeDelta(CompactState* curr, CompactState* prev, CompactDelta* delta) {
+	curr->count = 0;
+
+	Reader reader = {delta->data, delta->size, 0, false};
+	curr->tick = ReadDiff32(&reader, prev->tick);
+
+	uint32_t id = 0;
+	int p = 0;
+	while (reader.pos < reader.size && !reader.failed) {
+		id += ReadVarint(&reader);
+		uint16_t fields = ReadVarint(&reader);
+
+		// Objects before this one didn't change
+		while (p < prev->count && prev->objects[p].id < id) AddObject(curr, prev->objects[p++]);
+
+		CompactObject obj = {.id = id};
+		if (p < prev->count && prev->objects[p].id == id) obj = prev->objects[p++];
+		else if (fields & COMPACT_REMOVED) return false; // Removing an object that isn't there
+
+		if (fields & COMPACT_REMOVED) continue;
+
+		if (fields & COMPACT_POS) {
+			obj.x = ReadDiff32(&reader, obj.x);
+			obj.y = ReadDiff32(&reader, obj.y);
+		}
+		if (fields & COMPACT_VEL) {
+			obj.velX = ReadDiff(&reader, obj.velX);
+			obj.velY = ReadDiff(&reader, obj.velY);
+		}
+		if (fields & COMPACT_ROT) obj.rot = ReadDiff(&reader, obj.rot);
+		if (fields & COMPACT_SPIN) obj.spin = ReadDiff(&reader, obj.spin);
+		if (fields & COMPACT_LIFETIME) obj.lifetime = ReadDiff(&reader, obj.lifetime);
+		if (fields & COMPACT_HEALTH) {
+			obj.health = ReadByte(&reader);
+			obj.maxHealth = ReadByte(&reader);
+		}
+		if (fields & COMPACT_STATIC) {
+			obj.radius = ReadByte(&reader);
+			obj.vertCount = ReadByte(&reader);
+			obj.type = ReadByte(&reader);
+			obj.layer = ReadByte(&reader);
+			obj.layerMask = ReadByte(&reader);
+			obj.color = ReadByte(&reader);
+		}
+		if (fields & COMPACT_SLEEP) obj.sleepTick = ReadDiff32(&reader, obj.sleepTick);
+
+		AddObject(curr, obj);
+	}
+
+	// Objects after the last record didn't change
+	while (p < prev->count) AddObject(curr, prev->objects[p++]);
+
+	return !reader.failed;
+}
+
+void FreeCompactDelta(CompactDelta* delta) {
+	free(delta->data);
+	*delta = (CompactDelta){0};
+}
+
@@ -0,0 +1,97 @@
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "object.h"
+#include "sector.h"
+#include "game.h"
+
+// Quantization
+#define COMPACT_MARGIN 128 // Objects wrap once fully outside of the area, so positions go past its edges by up to their radius
+#define COMPACT_POS_SCALE 256 // Steps per pixel, the same for any area so slow objects still move every tick
+#define COMPACT_POS_RANGE_X ((AREA_W + 2LL*COMPACT_MARGIN) * COMPACT_POS_SCALE) // Steps positions wrap at (the area and its margins)
+#define COMPACT_POS_RANGE_Y ((AREA_H + 2LL*COMPACT_MARGIN) * COMPACT_POS_SCALE)
+#define COMPACT_VEL_SCALE 32.0f // Steps per pixel/sec, up to 1024 pixels/sec
+#define COMPACT_ROT_SCALE (65536.0f / (2*PI)) // Steps per radian, angles wrap modulo a full turn
+#define COMPACT_SPIN_SCALE 1024.0f // Steps per rad/sec, up to 32 rad/sec
+#define COMPACT_NO_LIFETIME 0xFFFF
+#define COMPACT_LIFETIME_EPSILON 0.01 // Ticks, lifetimes closer than this to a whole number of ticks are counted down like Process does
+
+_Static_assert(COMPACT_POS_RANGE_X <= UINT32_MAX && COMPACT_POS_RANGE_Y <= UINT32_MAX,
+	"AREA_W/AREA_H are too big for compact positions at 1/COMPACT_POS_SCALE pixel resolution");
+
+// Fields of a delta record
+#define COMPACT_POS      1<<0
+#define COMPACT_VEL      1<<1
+#define COMPACT_ROT      1<<2
+#define COMPACT_SPIN     1<<3
+#define COMPACT_LIFETIME 1<<4
+#define COMPACT_HEALTH   1<<5
+#define COMPACT_STATIC   1<<6 // Fields that only change when the object is created
+#define COMPACT_REMOVED  1<<7
+#define COMPACT_SLEEP    1<<8 // Fields are varints, so the rare ones come last
+
+// Quantized state of an object, without its shape (vertices never change after it is created)
+typedef struct {
+	uint32_t id;
+
+	uint32_t x, y; // Fixed point, wrapped modulo the area and its margins
+	uint32_t sleepTick; // 1 + the tick a dormant object is at (its sector's sleep time), 0 for active objects, which are at the state's tick
+	int16_t velX, velY;
+
+	uint16_t rot;
+	int16_t spin;
+
+	uint16_t lifetime; // Ticks until it is destroyed, COMPACT_NO_LIFETIME means it won't be
+
+	int8_t health;
+	uint8_t maxHealth;
+
+	uint8_t radius;
+	uint8_t vertCount;
+	uint8_t type;
+	uint8_t layer;
+	uint8_t layerMask;
+	uint8_t color; // Index in the palette
+} CompactObject;
+
+// Objects of a game sorted by id
+typedef struct {
+	uint32_t tick; // Tick of the game the state is from
+	CompactObject* objects;
+	int count;
+	int capacity;
+} CompactState;
+
+// Changes from one state to the next, as how far the tick moved and then records of the objects that changed in order of id
+typedef struct {
+	uint8_t* data;
+	int size;
+	int capacity;
+} CompactDelta;
+
+// Lifetimes are stored in ticks of tickTime (the fixed delta time the game is processed with),
+// so a packed object is destroyed on the same tick as the original
+CompactObject PackObject(Object* obj, float tickTime);
+
+// Sets the state of obj, keeping its vertices (a dormant object stays at its sleepTick, AdvanceObject brings it to the state's tick)
+void UnpackObject(CompactObject* compact, Object* obj, float tickTime);
+
+// Packs all objects of the game, dormant ones included (they are packed at the time they are at, not advanced to the game's)
+void PackGame(CompactState* state, GameContext* ctx, float tickTime);
+
+void FreeCompactState(CompactState* state);
+
+// Writes the changes from prev to curr in delta
+void EncodeDelta(CompactDelta* delta, CompactState* prev, CompactState* curr);
+
+// Applies delta to prev, writing the result in curr
+// returns: false if the delta is malformed
+bool DecodeDelta(CompactState* curr, CompactState* prev, CompactDelta* delta);
+
+void FreeCompactDelta(CompactDelta* delta);
+
+#endif
+
@@ -0,0 +1,120 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <signal.h>
+
+#include "eventlog.h"
+
+#define EVENT_LOG_MASK (EVENT_LOG_SIZE - 1)
+#define WRITER_SLEEP_NS 2000000 // Time the writer waits when there are no events
+
+static const char* EventName(int type) {
+	switch (type) {
+		case EVENT_LEVEL_START: return "level_start";
+		case EVENT_LEVEL_WON:   return "level_won";
+		case EVENT_LEVEL_LOST:  return "level_lost";
+		case EVENT_HIT:         return "hit";
+		case EVENT_KILL:        return "kill";
+		case EVENT_SPLIT:       return "split";
+		case EVENT_PROJECTILE:  return "projectile";
+		case EVENT_FRAME_SPIKE: return "frame_spike";
+		default:                return "unknown";
+	}
+}
+
+static void WriteEvent(EventLog* log, Event* event) {
+	fprintf(log->file, "{\"t\":%.4f,\"event\":\"%s\",\"obj\":%d,\"value\":%d,\"x\":%.1f,\"y\":%.1f,\"duration\":%.4f}\n",
+		event->time, EventName(event->type), event->objType, event->value, event->pos.x, event->pos.y, event->duration);
+
+	// Console messages
+	if (event->type == EVENT_LEVEL_START) printf("Starting level: %d\n", event->value);
+	if (event->type == EVENT_LEVEL_LOST) puts("Lost! :(");
+}
+
+// returns: number of events written
+static int DrainEvents(EventLog* log) {
+	size_t tail = atomic_load_explicit(&log->tail, memory_order_relaxed);
+	size_t head = atomic_load_explicit(&log->head, memory_order_acquire);
+
+	for (size_t i = tail; i != head; ++i) {
+		WriteEvent(log, &log->events[i & EVENT_LOG_MASK]);
+	}
+
+	// Giving the slots back to the game
+	atomic_store_explicit(&log->tail, head, memory_order_release);
+	return head - tail;
+}
+
+static void* WriterThread(void* arg) {
+	EventLog* log = arg;
+	struct timespec wait = {0, WRITER_SLEEP_NS};
+
+	while (atomic_load_explicit(&log->running, memory_order_relaxed)) {
+		if (DrainEvents(log) == 0) {
+			fflush(log->file);
+			fflush(stdout);
+			nanosleep(&wait, NULL);
+		}
+	}
+
+	return NULL;
+}
+
+EventLog* OpenEventLog(const char* path) {
+	FILE* file = fopen(path, "w");
+	if (!file) return NULL;
+
+	EventLog* log = aligned_alloc(_Alignof(EventLog), sizeof(EventLog));
+	log->file = file;
+	atomic_init(&log->head, 0);
+	atomic_init(&log->tail, 0);
+	log->cachedTail = 0;
+	atomic_init(&log->dropped, 0);
+	atomic_init(&log->running, true);
+
+	// Blocking SIGINT in the writer, so it's handled by the thread that opened the log
+	sigset_t block, previous;
+	sigemptyset(&block);
+	sigaddset(&block, SIGINT);
+	pthread_sigmask(SIG_BLOCK, &block, &previous);
+	pthread_create(&log->thread, NULL, WriterThread, log);
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+	return log;
+}
+
+void CloseEventLog(EventLog* log) {
+	if (!log) return;
+
+	atomic_store(&log->running, false);
+	pthread_join(log->thread, NULL);
+
+	// Writing what is left
+	DrainEvents(log);
+	fprintf(log->file, "{\"event\":\"dropped\",\"count\":%lu}\n", atomic_load(&log->dropped));
+
+	fclose(log->file);
+	free(log);
+}
+
+void LogEvent(EventLog* log, Event event) {
+	if (!log) return;
+
+	size_t head = atomic_load_explicit(&log->head, memory_order_relaxed);
+
+	// Ring looks full, checking how far the writer actually got
+	if (head - log->cachedTail == EVENT_LOG_SIZE) {
+		log->cachedTail = atomic_load_explicit(&log->tail, memory_order_acquire);
+
+		if (head - log->cachedTail == EVENT_LOG_SIZE) {
+			// Only the game changes dropped, so there's no need for an atomic increment
+			unsigned long dropped = atomic_load_explicit(&log->dropped, memory_order_relaxed);
+			atomic_store_explicit(&log->dropped, dropped + 1, memory_order_relaxed);
+			return;
+		}
+	}
+
+	log->events[head & EVENT_LOG_MASK] = event;
+	atomic_store_explicit(&log->head, head + 1, memory_order_release);
+}
+
@@ -0,0 +1,56 @@
+#ifndef EVENTLOG_H
+#define EVENTLOG_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <raylib.h>
+
+#define EVENT_LOG_SIZE 8192 // Events the ring buffer can hold, must be a power of two
+
+// Event types
+#define EVENT_LEVEL_START 0
+#define EVENT_LEVEL_WON   1
+#define EVENT_LEVEL_LOST  2
+#define EVENT_HIT         3
+#define EVENT_KILL        4
+#define EVENT_SPLIT       5
+#define EVENT_PROJECTILE  6
+#define EVENT_FRAME_SPIKE 7
+
+typedef struct {
+	double time; // Simulation time of the event
+	float duration; // Level or frame duration, in seconds
+	Vector2 pos;
+	short type;
+	short objType; // Type of the object involved
+	int value; // Level, health left or radius, depending on the type
+} Event;
+
+// Single-producer single-consumer ring buffer of events, written to a file by a background thread
+typedef struct {
+	Event events[EVENT_LOG_SIZE];
+
+	// Kept in separate cache lines so the game and the writer don't fight over them
+	_Alignas(64) atomic_size_t head; // Next slot to write, only changed by the game
+	size_t cachedTail; // Last tail seen by the game, so it only reads tail again when the ring looks full
+	atomic_ulong dropped; // Events lost because the ring was full, only changed by the game
+	_Alignas(64) atomic_size_t tail; // Next slot to read, only changed by the writer
+
+	atomic_bool running;
+	FILE* file;
+	pthread_t thread;
+} EventLog;
+
+// returns: event log writing to the file at path, or NULL if it can't be opened
+EventLog* OpenEventLog(const char* path);
+
+// Writes the remaining events and the dropped count, then closes the file and frees the log
+void CloseEventLog(EventLog* log);
+
+// Records an event without blocking, counting it as dropped if the ring is full (does nothing if log is NULL)
+void LogEvent(EventLog* log, Event event);
+
+#endif
+
@@ -0,0 +1,582 @@
+#include <stdlib.h>
+
+#include <raylib.h>
+#include <raymath.h>
+
+#include "game.h"
+
+// Object counts are tuned for a 4000x4000 area, and scaled with the actual one
+#define AREA_SCALE ((double)AREA_W/4000 * AREA_H/4000)
+
+// Player
+#define PLAYER_ACCEL 600.0
+#define PLAYER_DEACCEL 300.0
+#define PLAYER_VEL_CAP 600.0
+#define PLAYER_ROT_SPEED 3.5
+#define PLAYER_RADIUS 15 // Radius for collision checking
+#define PLAYER_SIZE    7 // Actual size of the triangle
+#define PLAYER_SHOOT_DELAY 0.15
+#define PLAYER_HEALTH 5
+#define PLAYER_HEALTH_MAX 10
+#define PLAYER_INVUL_SEC 0.5 // Time between hits
+#define PLAYER_KNOCKBACK 100 // Knockback from getting hit
+
+// Asteroid
+#define ASTEROID_COUNT_BASE 15
+#define ASTEROID_COUNT_INCR 5 // increment
+
+#define ASTEROID_MIN_VERTS  7
+#define ASTEROID_MAX_VERTS 12
+
+#define ASTEROID_MIN_SIZE  40
+#define ASTEROID_MAX_SIZE 100
+#define ASTEROID_DESTROY_SIZE 20
+
+#define ASTEROID_MIN_VEL 150.0
+#define ASTEROID_MAX_VEL 300.0
+#define ASTEROID_VEL_SCALE_FACTOR 20 // higher = size matters less
+
+#define ASTEROID_DISTORTION 15
+
+#define ASTEROID_ROT_SPEED 30.0
+
+#define ASTEROID_MAX_HEALTH 5
+#define ASTEROID_MIN_HEALTH 1
+
+// Projectile
+#define PROJECTILE_RADIUS 2
+#define PROJECTILE_OFFSET 10
+#define PROJECTILE_VEL 800.0
+#define PROJECTILE_LIFETIME 0.35
+#define ENEMY_PROJ_VEL 200.0
+#define ENEMY_PROJ_LIFETIME 2.0
+#define PROJECTILE_HEALTH 1
+
+// Enemy Base
+#define BASE_RADIUS 35
+#define BASE_SIDES 8
+#define BASE_HEALTH 15
+#define BASE_SHOOT_DELAY 2.0 // in seconds
+
+// Particles
+#define DEBRIS_PER_RADIUS 2 // Debris particles per unit of radius of destroyed objects
+#define DEBRIS_SPEED 150.0
+#define DEBRIS_LIFETIME 1.5
+#define SPARK_COUNT 12 // Sparks per hit
+#define SPARK_SPEED 250.0
+#define SPARK_LIFETIME 0.4
+#define THRUSTER_RATE 200.0 // Particles per second
+#define THRUSTER_VEL 250.0 // Speed the particles leave the back of the ship at
+#define THRUSTER_SPREAD 60.0
+#define THRUSTER_LIFETIME 0.5
+
+#define NO_ASTEROID_RADIUS 130 // Radius around the player where asteroids can't spawn
+void InitGame(GameContext* ctx, uint64_t seed) {
+	*ctx = (GameContext){0};
+
+	InitSectors(&ctx->sectors);
+
+	// Seeding (xorshift can't have a state of 0)
+	ctx->rngState = seed * 0x9E3779B97F4A7C15ULL + 1;
+	if (ctx->rngState == 0) ctx->rngState = 1;
+
+	ctx->camera = (Camera2D){
+		.offset = (Vector2){WIDTH/2, HEIGHT/2},
+		.target = (Vector2){WIDTH/2, HEIGHT/2},
+		.rotation = 0,
+		.zoom = 1,
+	};
+}
+
+static void FreeObjects(GameContext* ctx) {
+	Node* node = ctx->objs_head;
+	while (node != NULL) {
+		Node* next = node->next;
+		FreeNode(node);
+		node = next;
+	}
+
+	ctx->objs_head = NULL;
+	ctx->player = NULL;
+
+	ClearSectors(&ctx->sectors);
+}
+
+void FreeGame(GameContext* ctx) {
+	FreeObjects(ctx);
+	FreeSectors(&ctx->sectors);
+
+	free(ctx->bursts);
+	ctx->bursts = NULL;
+	ctx->burstCount = 0;
+	ctx->burstCapacity = 0;
+}
+
+// Records particles for whoever draws the game
+static void AddBurst(GameContext* ctx, ParticleBurst burst) {
+	if (!ctx->effects || burst.count <= 0) return;
+
+	if (ctx->burstCount == ctx->burstCapacity) {
+		ctx->burstCapacity = ctx->burstCapacity? ctx->burstCapacity * 2 : 16;
+		ctx->bursts = realloc(ctx->bursts, ctx->burstCapacity * sizeof(ParticleBurst));
+	}
+
+	ctx->bursts[ctx->burstCount++] = burst;
+}
+
+int GetGameRandom(GameContext* ctx, int min, int max) {
+	if (min > max) {
+		int tmp = max;
+		max = min;
+		min = tmp;
+	}
+
+	// xorshift64*
+	ctx->rngState ^= ctx->rngState >> 12;
+	ctx->rngState ^= ctx->rngState << 25;
+	ctx->rngState ^= ctx->rngState >> 27;
+	uint64_t value = ctx->rngState * 0x2545F4914F6CDD1DULL;
+
+	return min + (value >> 32) % ((uint64_t)max - min + 1);
+}
+
+static void InitPlayer(GameContext* ctx) {
+	// Allocating
+	ctx->player = calloc(1, sizeof(Object));
+	ctx->player->id = ++ctx->lastId;
+
+	// Position and rotation
+	ctx->player->pos = (Vector2){AREA_W/2, AREA_H/2};
+	ctx->player->rot = 0;
+	ctx->player->vel = (Vector2){0};
+	ctx->player->spin = 0;
+
+	// Radius
+	ctx->player->radius = PLAYER_RADIUS;
+
+	// Vertices
+	ctx->player->vertCount = 3;
+	ctx->player->vertices   = malloc(ctx->player->vertCount * sizeof(Vector2));
+	ctx->player->transVerts = malloc(ctx->player->vertCount * sizeof(Vector2));
+
+	ctx->player->vertices[0] = (Vector2){           0, -PLAYER_SIZE},
+	ctx->player->vertices[1] = (Vector2){ PLAYER_SIZE,  PLAYER_SIZE},
+	ctx->player->vertices[2] = (Vector2){-PLAYER_SIZE,  PLAYER_SIZE},
+
+	// Lifetime
+	ctx->player->lifetime = NO_LIFETIME;
+
+	// Type
+	ctx->player->type = TYPE_PLAYER;
+
+	// Health
+	ctx->player->maxHealth = PLAYER_HEALTH_MAX;
+	ctx->player->health = PLAYER_HEALTH;
+
+	// Layer
+	ctx->player->layer = LAYER_PLAYER;
+	ctx->player->layerMask = LAYER_ASTEROID | LAYER_BASE | LAYER_ENEMY_PROJ;
+
+	// Color
+	ctx->player->color = WHITE;
+}
+
+void CreateAsteroid(GameContext* ctx, Vector2 position, int radius) {
+	// Creating object
+	Node* astrNode = CreateObject();
+	Object* asteroid = astrNode->obj;
+	asteroid->id = ++ctx->lastId;
+
+	// Position and radius
+	asteroid->pos = position;
+	asteroid->radius = radius;
+
+	// Allocating vertices and transformed vertices array
+	asteroid->vertCount = GetGameRandom(ctx, ASTEROID_MIN_VERTS, ASTEROID_MAX_VERTS);
+	asteroid->vertices = malloc(asteroid->vertCount * sizeof(Vector2));
+	asteroid->transVerts = malloc(asteroid->vertCount * sizeof(Vector2));
+
+	// Positioning vertices
+	for (int i = 0; i < asteroid->vertCount; ++i) {
+		int dist = i == 0? asteroid->radius : asteroid->radius - GetGameRandom(ctx, 0, ASTEROID_DISTORTION); // The first vertex will have the max radius
+		float angle = (360*i/asteroid->vertCount)*DEG2RAD;
+		asteroid->vertices[i] = Vector2Rotate((Vector2){0, -dist}, angle);
+	}
+
+	// Setting velocity
+	float magnitude = GetGameRandom(ctx, ASTEROID_MIN_VEL, ASTEROID_MAX_VEL) / ((double)asteroid->radius/ASTEROID_VEL_SCALE_FACTOR);
+	asteroid->vel = Vector2Rotate((Vector2){0, -magnitude}, GetGameRandom(ctx, 0, PI*2));
+	asteroid->rot = 0;
+	asteroid->spin = ASTEROID_ROT_SPEED/asteroid->radius;
+
+	// Lifetime
+	asteroid->lifetime = NO_LIFETIME;
+
+	// Type
+	asteroid->type = TYPE_ASTEROID;
+
+	// Health
+	asteroid->maxHealth = ASTEROID_MIN_HEALTH + ASTEROID_MAX_HEALTH * Normalize(radius, ASTEROID_DESTROY_SIZE, ASTEROID_MAX_SIZE);
+	asteroid->health = asteroid->maxHealth;
+
+	// Layer
+	asteroid->layer = LAYER_ASTEROID;
+	asteroid->layerMask = 0; // Asteroid collisions are checked by the colliding objects
+
+	// Color
+	asteroid->color = WHITE;
+
+	// Appending node to objects list, or to its sector if it's dormant
+	PlaceNode(&ctx->sectors, astrNode, &ctx->objs_head, ctx->simTime);
+}
+
+void CreateProjectile(GameContext* ctx, int type, Vector2 pos) {
+	// Creating object and appending node to lists
+	Node* projNode = CreateObject();
+	InsertToList(projNode, &ctx->objs_head);
+
+	Object* proj = projNode->obj;
+	proj->id = ++ctx->lastId;
+	
+	// Transform
+	proj->pos = pos;
+	proj->rot = type == TYPE_PROJECTILE? ctx->player->rot : Vector2Angle((Vector2){0, -1}, Vector2Subtract(ctx->player->pos, pos));
+	float projVel = type == TYPE_PROJECTILE? PROJECTILE_VEL : ENEMY_PROJ_VEL;
+	proj->vel = Vector2Rotate((Vector2){0, -projVel}, proj->rot);
+	proj->spin = 0;
+
+	// Radius
+	proj->radius = PROJECTILE_RADIUS;
+
+	// Vertices
+	proj->vertCount = 1;
+	proj->vertices = malloc(sizeof(Vector2));
+	proj->transVerts = malloc(sizeof(Vector2));
+	proj->vertices[0] = (Vector2){0, 0};
+
+	// Lifetime
+	proj->lifetime = type == TYPE_PROJECTILE? PROJECTILE_LIFETIME : ENEMY_PROJ_LIFETIME;
+
+	// Type
+	proj->type = type;
+
+	// Health
+	proj->maxHealth = PROJECTILE_HEALTH;
+	proj->health = PROJECTILE_HEALTH;
+
+	// Layer
+	proj->layer = type == TYPE_PROJECTILE? LAYER_PROJECTILE : LAYER_ENEMY_PROJ;
+	proj->layerMask = type == TYPE_PROJECTILE? LAYER_ASTEROID | LAYER_BASE : 0;
+
+	// Color
+	proj->color = type == TYPE_PROJECTILE? WHITE : RED;
+
+	LogEvent(ctx->eventLog, (Event){.type = EVENT_PROJECTILE, .time = ctx->simTime, .objType = type, .pos = pos});
+}
+
+Vector2* RegularPolygon(int vertCount, int radius) {
+	Vector2* vertices = malloc(vertCount * sizeof(Vector2));
+	for (int i = 0; i < vertCount; ++i) {
+		int dist = radius;
+		float angle = (i*360/vertCount)*DEG2RAD;
+		vertices[i] = Vector2Rotate((Vector2){0, -dist}, angle);
+	}
+	return vertices;
+}
+
+void CreateEnemyBase(GameContext* ctx) {
+	// Creating object and appending node to lists
+	Node* baseNode = CreateObject();
+	InsertToList(baseNode, &ctx->objs_head);
+
+	Object* base = baseNode->obj;
+	base->id = ++ctx->lastId;
+
+	// Radius
+	base->radius = BASE_RADIUS;
+
+	// Randomizing position
+	Vector2 position;
+	do {
+		position = (Vector2){GetGameRandom(ctx, 0, AREA_W), GetGameRandom(ctx, 0, AREA_H)};
+	} while (position.x + base->radius > ctx->player->pos.x - base->radius &&
+		 position.x - base->radius < ctx->player->pos.x + base->radius &&
+		 position.y + base->radius > ctx->player->pos.y - base->radius &&
+		 position.y - base->radius < ctx->player->pos.y + base->radius); // Checking if it overlaps with the player
+
+	// Transform
+	base->pos = position;
+	base->vel = (Vector2){0, 0};
+	base->rot = 0;
+	base->spin = 0;
+
+	// Vertices
+	base->vertCount = BASE_SIDES;
+	base->vertices = RegularPolygon(base->vertCount, base->radius);
+	base->transVerts = malloc(base->vertCount*sizeof(Vector2));
+
+	// Lifetime
+	base->lifetime = NO_LIFETIME;
+
+	// Type
+	base->type = TYPE_BASE;
+
+	// Health
+	base->maxHealth = BASE_HEALTH;
+	base->health = BASE_HEALTH;
+
+	// Layer
+	base->layer = LAYER_BASE;
+	base->layerMask = 0; // Enemy base collisions are checked by the colliding objects
+
+	// Color
+	base->color = RED;
+}
+
+void Initialize(GameContext* ctx) {
+	ctx->levelStartTime = ctx->simTime;
+	LogEvent(ctx->eventLog, (Event){.type = EVENT_LEVEL_START, .time = ctx->simTime, .value = ctx->level});
+
+	if (!ctx->player) InitPlayer(ctx);
+
+	// Freeing what is left of the previous level (except for the player)
+	Node* node = ctx->objs_head;
+	while (node != NULL) {
+		Node* next = node->next;
+		if (node->obj == ctx->player) free(node);
+		else FreeNode(node);
+		node = next;
+	}
+
+	ctx->objs_head = malloc(sizeof(Node));
+	*ctx->objs_head = (Node){ctx->player, NULL, NULL};
+
+	// Activating the sectors around the player
+	ClearSectors(&ctx->sectors);
+	UpdateActiveSectors(&ctx->sectors, ctx->player->pos, PLAYER_VEL_CAP, &ctx->objs_head, ctx->simTime);
+
+	// Creating asteroids
+	int asteroidCount = (ASTEROID_COUNT_BASE + ctx->level * ASTEROID_COUNT_INCR) * AREA_SCALE;
+	for (int i = 0; i < asteroidCount; ++i) {
+		// Randomizing max radius
+		int rand1 = GetGameRandom(ctx, ASTEROID_MIN_SIZE, ASTEROID_MAX_SIZE);
+		int rand2 = GetGameRandom(ctx, ASTEROID_MIN_SIZE, ASTEROID_MAX_SIZE);
+		float radius = rand2 < rand1? rand2 : rand1; // Making it more likely for the radius to be small
+
+		// Randomizing position
+		Vector2 position;
+		do {
+			position = (Vector2){GetGameRandom(ctx, 0, AREA_W), GetGameRandom(ctx, 0, AREA_H)};
+		} while (position.x + radius > ctx->player->pos.x - NO_ASTEROID_RADIUS &&
+			 position.x - radius < ctx->player->pos.x + NO_ASTEROID_RADIUS &&
+			 position.y + radius > ctx->player->pos.y - NO_ASTEROID_RADIUS &&
+			 position.y - radius < ctx->player->pos.y + NO_ASTEROID_RADIUS); // Checking if it is inside the no asteroid radius around player
+
+		CreateAsteroid(ctx, position, radius);
+	}
+
+	// Creating enemy bases
+	int basesCount = ctx->level+1;
+	for (int i = 0; i < basesCount; ++i) {
+		CreateEnemyBase(ctx);
+	}
+}
+
+static bool CheckCollision(Object* this, Object* other) {
+	Object* obj = this->vertCount < other->vertCount? this : other; // We will iterate through the vertices of the object with least vertices
+	Object* poly = obj == this? other : this; // We will use the the object with more vertices as the polygon in the collision check
+	
+	for (int i = 0; i < obj->vertCount; ++i) {
+		if (CheckCollisionPointPoly(obj->transVerts[i], poly->transVerts, poly->vertCount)) return true;
+	}
+
+	return false;
+}
+
+void Process(GameContext* ctx, GameInput input, float deltaTime) {
+	// - Main Menu -
+	if (!ctx->player) {
+		if (input.play) Initialize(ctx);
+		return;
+	}
+
+	// - Game -
+	double currTime = ctx->simTime;
+
+	// Waking up the sectors around the player
+	UpdateActiveSectors(&ctx->sectors, ctx->player->pos, PLAYER_VEL_CAP, &ctx->objs_head, ctx->simTime);
+
+	// Player
+	  // - Movement
+	    // - Rotation
+	ctx->player->spin = input.turn * PLAYER_ROT_SPEED;
+
+	    // - Velocity
+	float accel = input.thrust * PLAYER_ACCEL * deltaTime;
+
+	ctx->player->vel = Vector2Add(ctx->player->vel, Vector2Rotate((Vector2){0, -accel}, ctx->player->rot));
+	ctx->player->vel = Vector2Subtract(ctx->player->vel, Vector2Scale(Vector2Normalize(ctx->player->vel), PLAYER_DEACCEL * deltaTime));
+
+	ctx->player->vel = Vector2ClampValue(ctx->player->vel, 0, PLAYER_VEL_CAP);
+
+	    // - Thruster trail
+	if (input.thrust > 0) {
+		ctx->thrusterParticles += THRUSTER_RATE * deltaTime;
+		int count = ctx->thrusterParticles;
+		ctx->thrusterParticles -= count;
+
+		Vector2 back = Vector2Rotate((Vector2){0, PLAYER_SIZE}, ctx->player->rot);
+		Vector2 trailVel = Vector2Add(ctx->player->vel, Vector2Scale(back, THRUSTER_VEL/PLAYER_SIZE));
+		AddBurst(ctx, (ParticleBurst){Vector2Add(ctx->player->pos, back), trailVel, count, THRUSTER_SPREAD, THRUSTER_LIFETIME, ORANGE});
+	}
+	  //
+
+	  // - Shooting
+	if (currTime - ctx->lastShoot > PLAYER_SHOOT_DELAY && input.shoot) {
+		CreateProjectile(ctx, TYPE_PROJECTILE, Vector2Add(ctx->player->pos, Vector2Rotate((Vector2){0, -PROJECTILE_OFFSET}, ctx->player->rot)));
+		ctx->lastShoot = currTime;
+	}
+
+	  // - Invulnerability indicator
+	bool invul = currTime - ctx->lastHit <= PLAYER_INVUL_SEC; // will be used later when checking hit
+	ctx->player->color = invul? GRAY : WHITE;
+	//
+
+	// Going through all objects
+	bool won = true;
+	bool baseShot = false;
+
+	Node* node = ctx->objs_head;
+	while (node != NULL) {
+		Object* obj = node->obj;
+
+		// Enemy base shooting
+		if (obj->type == TYPE_BASE) {
+			won = false;
+			if (IsPosActive(&ctx->sectors, obj->pos) && currTime - ctx->lastBaseShoot > BASE_SHOOT_DELAY) {
+				CreateProjectile(ctx, TYPE_ENEMY_PROJ, obj->pos);
+				baseShot = true;
+			}
+		}
+
+		// Applying movement
+		obj->rot += obj->spin * deltaTime;
+		obj->pos = Vector2Add(obj->pos, Vector2Scale(obj->vel, deltaTime));
+
+		// Wrapping
+		if (obj->pos.x - obj->radius > AREA_W) obj->pos.x -= AREA_W + obj->radius*2;
+		if (obj->pos.x + obj->radius < 0)      obj->pos.x += AREA_W + obj->radius*2;
+		if (obj->pos.y - obj->radius > AREA_H) obj->pos.y -= AREA_H + obj->radius*2;
+		if (obj->pos.y + obj->radius < 0)      obj->pos.y += AREA_H + obj->radius*2;
+
+		// Going dormant when outside of the active sectors (enemy bases are few and always simulated)
+		if (obj->type != TYPE_BASE && !IsPosActive(&ctx->sectors, obj->pos)) {
+			Node* next = node->next;
+			SleepNode(&ctx->sectors, node, &ctx->objs_head, ctx->simTime + deltaTime);
+			node = next;
+			continue;
+		}
+
+		// Getting transformed vertices
+		for (int i = 0; i < obj->vertCount; ++i) {
+			obj->transVerts[i] = Vector2Add(obj->pos, Vector2Rotate(obj->vertices[i], obj->rot));
+		}
+
+		// Lifetime
+		if (obj->lifetime != NO_LIFETIME && (obj->lifetime -= deltaTime) < 0) {
+			Node* next = node->next;
+			DestroyNode(node, &ctx->objs_head);
+			node = next;
+			continue;
+		}
+
+		// Collision
+		for (Node* other = ctx->objs_head; other != NULL; other = other->next) {
+			Object* otherObj = other->obj;
+
+			if (!(otherObj->layer & obj->layerMask)) continue; // Other object is not in the layer mask
+			if (Vector2Distance(obj->pos, otherObj->pos) > obj->radius + otherObj->radius) continue; // Other object is not in range
+			if (!CheckCollision(obj, otherObj)) continue; // The objects don't collide
+
+			if (obj->type == TYPE_PLAYER && (otherObj->type == TYPE_ASTEROID || otherObj->type == TYPE_BASE || otherObj->type == TYPE_ENEMY_PROJ)) {
+				// If player isn't invulnerable, damage player
+				if (!invul) {
+					--obj->health;
+					ctx->lastHit = currTime;
+					LogEvent(ctx->eventLog, (Event){.type = EVENT_HIT, .time = ctx->simTime, .objType = obj->type, .value = obj->health, .pos = obj->pos});
+					AddBurst(ctx, (ParticleBurst){obj->pos, obj->vel, SPARK_COUNT, SPARK_SPEED, SPARK_LIFETIME, YELLOW});
+				}
+
+				// Knockback
+				Vector2 knockDir = Vector2Normalize(Vector2Subtract(ctx->player->pos, otherObj->pos));
+				ctx->player->vel = Vector2Scale(knockDir, PLAYER_KNOCKBACK);
+
+				break;
+			}
+
+			if (obj->type == TYPE_PROJECTILE && (otherObj->type == TYPE_ASTEROID || otherObj->type == TYPE_BASE)) {
+				--obj->health;
+				--otherObj->health;
+				LogEvent(ctx->eventLog, (Event){.type = EVENT_HIT, .time = ctx->simTime, .objType = otherObj->type, .value = otherObj->health, .pos = otherObj->pos});
+				AddBurst(ctx, (ParticleBurst){obj->pos, otherObj->vel, SPARK_COUNT, SPARK_SPEED, SPARK_LIFETIME, YELLOW});
+				break;
+			}
+		}
+
+		// Health
+		bool destroyed = false;
+		if (obj->health <= 0) { // Object died
+			if (obj->type == TYPE_ASTEROID || obj->type == TYPE_BASE) {
+				LogEvent(ctx->eventLog, (Event){.type = EVENT_KILL, .time = ctx->simTime, .objType = obj->type, .value = obj->radius, .pos = obj->pos});
+			}
+
+			// Debris
+			if (obj->type != TYPE_PROJECTILE) {
+				AddBurst(ctx, (ParticleBurst){obj->pos, obj->vel, obj->radius * DEBRIS_PER_RADIUS, DEBRIS_SPEED, DEBRIS_LIFETIME, obj->color});
+			}
+
+			if (obj->type == TYPE_ASTEROID && obj->radius/2 > ASTEROID_DESTROY_SIZE) {
+				// If it's an asteroid and it's big enough, create two more
+				CreateAsteroid(ctx, obj->pos, obj->radius/2);
+				CreateAsteroid(ctx, obj->pos, obj->radius/2);
+				LogEvent(ctx->eventLog, (Event){.type = EVENT_SPLIT, .time = ctx->simTime, .objType = obj->type, .value = obj->radius/2, .pos = obj->pos});
+			} else if (obj->type == TYPE_PLAYER) {
+				// If it's the player, lose
+				LogEvent(ctx->eventLog, (Event){.type = EVENT_LEVEL_LOST, .time = ctx->simTime, .value = ctx->level, .duration = ctx->simTime - ctx->levelStartTime});
+				if (ctx->level > ctx->highscore) ctx->highscore = ctx->level;
+				ctx->level = 0;
+				FreeObjects(ctx);
+				return;
+			}
+
+			// Destroying
+			Node* next = node->next;
+			DestroyNode(node, &ctx->objs_head);
+			node = next;
+			destroyed = true;
+		}
+		//
+
+		if (!destroyed) node = node->next;
+	}
+
+	ctx->simTime += deltaTime;
+
+	if (baseShot) {
+		ctx->lastBaseShoot = currTime;
+	}
+
+	// Move camera
+	Vector2 newTarget;
+	newTarget.x = Clamp(ctx->player->pos.x, WIDTH /2, AREA_W-(WIDTH /2));
+	newTarget.y = Clamp(ctx->player->pos.y, HEIGHT/2, AREA_H-(HEIGHT/2));
+	ctx->camera.target = newTarget;
+
+	// Going to next level when there are no more enemy bases
+	if (!won) return;
+	if (ctx->player->health < ctx->player->maxHealth) ++ctx->player->health;
+	LogEvent(ctx->eventLog, (Event){.type = EVENT_LEVEL_WON, .time = ctx->simTime, .value = ctx->level, .duration = ctx->simTime - ctx->levelStartTime});
+	++ctx->level;
+	Initialize(ctx);
+}
+
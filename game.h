@@ -0,0 +1,95 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <raylib.h>
+
+#include "object.h"
+#include "sector.h"
+#include "eventlog.h"
+#include "particles.h"
+
+// Screen size (the camera is kept inside the area)
+#define WIDTH  800
+#define HEIGHT 600
+
+// Object types
+#define TYPE_PLAYER     0
+#define TYPE_ASTEROID   1
+#define TYPE_PROJECTILE 2
+#define TYPE_ENEMY_PROJ 3
+#define TYPE_BASE       4
+
+// Object layers
+#define LAYER_PLAYER     1<<0
+#define LAYER_ASTEROID   1<<1
+#define LAYER_PROJECTILE 1<<2
+#define LAYER_ENEMY_PROJ 1<<3
+#define LAYER_BASE       1<<4
+
+// Player controls for a tick
+typedef struct {
+	int turn;   // -1 turns left, 1 turns right
+	int thrust; // -1 goes back, 1 goes forward
+	bool shoot;
+	bool play;  // Starts the game when in the main menu
+} GameInput;
+
+// All the state of one game, so many games can run at once
+typedef struct {
+	// First element of list of all objects
+	Node* objs_head;
+
+	// Dormant objects, by sector
+	SectorGrid sectors;
+	double simTime; // Sum of the delta times of all ticks
+
+	// Gameplay events (NULL means they aren't logged)
+	EventLog* eventLog;
+	double levelStartTime;
+
+	// Debris, sparks and trails emitted since they were last taken (only recorded if effects is true)
+	bool effects;
+	ParticleBurst* bursts;
+	int burstCount;
+	int burstCapacity;
+	float thrusterParticles; // Fraction of a particle left from the last tick
+
+	Object* player; // NULL when in the main menu
+	double lastShoot;
+	double lastHit;
+	double lastBaseShoot;
+
+	int level;
+	int highscore;
+
+	Camera2D camera;
+
+	unsigned int lastId; // Id of the last object created
+
+	uint64_t rngState;
+} GameContext;
+
+void InitGame(GameContext* ctx, uint64_t seed);
+
+// Frees all objects and particle bursts of the game (the event log is not closed)
+void FreeGame(GameContext* ctx);
+
+// returns: random integer between min and max (both included), from the game's own generator
+int GetGameRandom(GameContext* ctx, int min, int max);
+
+void Initialize(GameContext* ctx);
+
+void Process(GameContext* ctx, GameInput input, float deltaTime);
+
+void CreateAsteroid(GameContext* ctx, Vector2 position, int radius);
+
+void CreateProjectile(GameContext* ctx, int type, Vector2 pos);
+
+void CreateEnemyBase(GameContext* ctx);
+
+Vector2* RegularPolygon(int vertCount, int radius);
+
+#endif
+
@@ -11,13 +11,21 @@ void FreeNode(Node* node) {
 	free(node);
 }
 
-// Unlinks Node node from list starting at Node head and then frees
-void DestroyNode(Node* node, Node** head) {
-	// Unlinking node
+// Unlinks Node node from list starting at Node head without freeing it
+void UnlinkNode(Node* node, Node** head) {
 	if (node->next) node->next->prev = node->prev;
 	if (node->prev) node->prev->next = node->next;
 	else *head = node->next;
 
+	node->next = NULL;
+	node->prev = NULL;
+}
+
+// Unlinks Node node from list starting at Node head and then frees
+void DestroyNode(Node* node, Node** head) {
+	// Unlinking node
+	UnlinkNode(node, head);
+
 	// Freeing
 	FreeNode(node);
 }
@@ -26,15 +34,16 @@ void DestroyNode(Node* node, Node** head) {
 // node: node to insert
 // head: first element of the list
 void InsertToList(Node* node, Node** head) {
-	(*head)->prev = node;
+	if (*head) (*head)->prev = node;
+	node->prev = NULL;
 	node->next = *head;
 	*head = node;
 }
 
 // returns: node of the object
 Node* CreateObject() {
-	// Allocating memory for object
-	Object* obj = malloc(sizeof(Object));
+	// Allocating memory for object (zeroed, so fields a type doesn't use don't depend on what was in memory)
+	Object* obj = calloc(1, sizeof(Object));
 
 	// Creating node for the object
 	Node* objNode = malloc(sizeof(Node));
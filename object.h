@@ -3,7 +3,11 @@
 
 #include <raylib.h>
 
+#define NO_LIFETIME -1
+
 typedef struct {
+	unsigned int id; // Unique in its game, used to match objects between snapshots
+
 	Vector2 pos;
 	Vector2 vel;
 
@@ -41,6 +45,9 @@ typedef struct Node {
 
 void FreeNode(Node* node);
 
+// Unlinks Node node from list starting at Node head without freeing it
+void UnlinkNode(Node* node, Node** head);
+
 // Unlinks Node node from list starting at Node head and then frees
 void DestroyNode(Node* node, Node** head);
 
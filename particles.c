@@ -0,0 +1,173 @@
+#include <stdlib.h>
+#include <math.h>
+#include <raylib.h>
+#include <rlgl.h>
+
+#include "particles.h"
+
+#define PARTICLE_MASK (PARTICLE_CAPACITY - 1)
+#define PARTICLE_BATCH 4096 // Lines drawn per rlBegin/rlEnd, so the render batch never overflows
+
+// 4 floats processed at once, compiled to SSE/NEON/WASM SIMD depending on the target
+typedef float Float4 __attribute__((vector_size(16)));
+typedef int Int4 __attribute__((vector_size(16))); // Result of comparing Float4s, -1 where true
+
+static float* AllocFloats() {
+	return aligned_alloc(sizeof(Float4), PARTICLE_CAPACITY * sizeof(float));
+}
+
+ParticleSystem* CreateParticleSystem() {
+	ParticleSystem* ps = malloc(sizeof(ParticleSystem));
+
+	ps->x = AllocFloats();
+	ps->y = AllocFloats();
+	ps->velX = AllocFloats();
+	ps->velY = AllocFloats();
+	ps->life = AllocFloats();
+	ps->invLifetime = AllocFloats();
+	ps->color = malloc(PARTICLE_CAPACITY * sizeof(Color));
+
+	// All particles start dead
+	for (int i = 0; i < PARTICLE_CAPACITY; ++i) ps->life[i] = 0;
+
+	ps->head = 0;
+	ps->tail = 0;
+	ps->alive = 0;
+	ps->rngState = 0x9E3779B9;
+
+	return ps;
+}
+
+void FreeParticleSystem(ParticleSystem* ps) {
+	if (!ps) return;
+
+	free(ps->x);
+	free(ps->y);
+	free(ps->velX);
+	free(ps->velY);
+	free(ps->life);
+	free(ps->invLifetime);
+	free(ps->color);
+	free(ps);
+}
+
+// returns: random float between 0 and 1 (xorshift32)
+static float RandomFloat(ParticleSystem* ps) {
+	ps->rngState ^= ps->rngState << 13;
+	ps->rngState ^= ps->rngState >> 17;
+	ps->rngState ^= ps->rngState << 5;
+	return (ps->rngState >> 8) * (1.0f / (1 << 24));
+}
+
+void EmitParticles(ParticleSystem* ps, Vector2 pos, Vector2 vel, int count, float speed, float lifetime, Color color) {
+	if (!ps) return;
+
+	for (int i = 0; i < count; ++i) {
+		size_t slot = ps->head & PARTICLE_MASK;
+
+		float angle = RandomFloat(ps) * 2*PI;
+		float particleSpeed = RandomFloat(ps) * speed;
+		float life = lifetime * (0.5f + RandomFloat(ps) * 0.5f);
+
+		ps->x[slot] = pos.x;
+		ps->y[slot] = pos.y;
+		ps->velX[slot] = vel.x + cosf(angle) * particleSpeed;
+		ps->velY[slot] = vel.y + sinf(angle) * particleSpeed;
+		ps->life[slot] = life;
+		ps->invLifetime[slot] = 1 / life;
+		ps->color[slot] = color;
+
+		++ps->head;
+	}
+
+	// Ring is full, dropping the oldest particles
+	if (ps->head - ps->tail > PARTICLE_CAPACITY) {
+		ps->tail = (ps->head - PARTICLE_CAPACITY + 3) & ~(size_t)3;
+	}
+}
+
+void EmitBurst(ParticleSystem* ps, ParticleBurst burst) {
+	EmitParticles(ps, burst.pos, burst.vel, burst.count, burst.speed, burst.lifetime, burst.color);
+}
+
+void UpdateParticles(ParticleSystem* ps, float deltaTime) {
+	if (!ps) return;
+
+	float drag = 1 - PARTICLE_DRAG * deltaTime;
+	if (drag < 0) drag = 0;
+
+	Int4 alive = {0};
+
+	// Integrating 4 particles at a time (tail is a multiple of 4 and so is the capacity, so blocks never wrap)
+	for (size_t i = ps->tail; i < ps->head; i += 4) {
+		size_t slot = i & PARTICLE_MASK;
+
+		Float4* x = (Float4*)&ps->x[slot];
+		Float4* y = (Float4*)&ps->y[slot];
+		Float4* velX = (Float4*)&ps->velX[slot];
+		Float4* velY = (Float4*)&ps->velY[slot];
+		Float4* life = (Float4*)&ps->life[slot];
+
+		*x += *velX * deltaTime;
+		*y += *velY * deltaTime;
+		*velX *= drag;
+		*velY *= drag;
+		*life -= deltaTime;
+		alive -= *life > 0;
+	}
+
+	// Not counting the slots past head in the last block, they hold particles that were dropped
+	ps->alive = alive[0] + alive[1] + alive[2] + alive[3];
+	if ((ps->head & ~(size_t)3) >= ps->tail) {
+		for (size_t i = ps->head; i & 3; ++i) ps->alive -= ps->life[i & PARTICLE_MASK] > 0;
+	}
+
+	// Freeing the blocks at the tail that are all dead
+	while (ps->tail + 4 <= ps->head) {
+		float* life = &ps->life[ps->tail & PARTICLE_MASK];
+		if (life[0] > 0 || life[1] > 0 || life[2] > 0 || life[3] > 0) break;
+		ps->tail += 4;
+	}
+}
+
+void DrawParticles(ParticleSystem* ps, Rectangle view) {
+	if (!ps) return;
+
+	int batched = 0;
+	rlBegin(RL_LINES);
+
+	for (size_t i = ps->tail; i < ps->head; ++i) {
+		size_t slot = i & PARTICLE_MASK;
+		if (ps->life[slot] <= 0) continue;
+
+		float x = ps->x[slot];
+		float y = ps->y[slot];
+		if (x < view.x || x > view.x + view.width || y < view.y || y > view.y + view.height) continue;
+
+		// Starting a new batch before the current one gets too big
+		if (batched == PARTICLE_BATCH) {
+			rlEnd();
+			rlCheckRenderBatchLimit(PARTICLE_BATCH * 2);
+			rlBegin(RL_LINES);
+			batched = 0;
+		}
+
+		// Fading out as it dies
+		Color color = ps->color[slot];
+		color.a *= ps->life[slot] * ps->invLifetime[slot];
+
+		rlColor4ub(color.r, color.g, color.b, color.a);
+		rlVertex2f(x, y);
+		rlVertex2f(x - ps->velX[slot] * PARTICLE_STREAK, y - ps->velY[slot] * PARTICLE_STREAK);
+		++batched;
+	}
+
+	rlEnd();
+}
+
+int GetParticleCount(ParticleSystem* ps) {
+	if (!ps) return 0;
+
+	return ps->alive;
+}
+
@@ -0,0 +1,60 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <raylib.h>
+
+#define PARTICLE_CAPACITY 131072 // Fixed budget, must be a power of two
+#define PARTICLE_DRAG 1.5 // Fraction of velocity lost per second
+#define PARTICLE_STREAK 0.02 // Length of the drawn line, in seconds of velocity
+
+// Particles emitted at once, so they can be handed over to whoever owns the particle system
+typedef struct {
+	Vector2 pos;
+	Vector2 vel; // Velocity added to all particles
+	int count;
+	float speed; // Maximum speed of the random directions
+	float lifetime;
+	Color color;
+} ParticleBurst;
+
+// Particles stored as a structure of arrays in a ring buffer
+// When the ring is full the oldest particles are overwritten
+typedef struct {
+	float* x;
+	float* y;
+	float* velX;
+	float* velY;
+	float* life; // Seconds left, dead when <= 0
+	float* invLifetime; // 1 / initial life, for fading out
+	Color* color;
+
+	size_t head; // Total particles emitted, the next one goes to head % PARTICLE_CAPACITY
+	size_t tail; // Oldest particle that may still be alive, always a multiple of 4
+	int alive; // Particles alive after the last update (the ring also holds dead ones behind long-lived particles)
+
+	uint32_t rngState; // Particles have their own generator so they don't change gameplay randomness
+} ParticleSystem;
+
+ParticleSystem* CreateParticleSystem();
+
+void FreeParticleSystem(ParticleSystem* ps);
+
+// Emits count particles at pos going in random directions (does nothing if ps is NULL)
+// vel: velocity added to all particles
+// speed: maximum speed of the random directions
+void EmitParticles(ParticleSystem* ps, Vector2 pos, Vector2 vel, int count, float speed, float lifetime, Color color);
+
+void EmitBurst(ParticleSystem* ps, ParticleBurst burst);
+
+void UpdateParticles(ParticleSystem* ps, float deltaTime);
+
+// Draws the particles inside the rectangle of the world that is visible, as a single batch of lines
+void DrawParticles(ParticleSystem* ps, Rectangle view);
+
+// returns: number of particles alive after the last update
+int GetParticleCount(ParticleSystem* ps);
+
+#endif
+
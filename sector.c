@@ -0,0 +1,291 @@
+#include <stdlib.h>
+#include <math.h>
+#include <raylib.h>
+#include <raymath.h>
+
+#include "sector.h"
+
+void InitSectors(SectorGrid* grid) {
+	grid->sectors = calloc(SECTORS_X * SECTORS_Y, sizeof(Sector));
+	grid->wakeQueue = malloc(SECTORS_X * SECTORS_Y * sizeof(int));
+	ClearSectors(grid);
+}
+
+void FreeSectors(SectorGrid* grid) {
+	if (!grid->sectors) return;
+
+	ClearSectors(grid);
+	free(grid->sectors);
+	free(grid->wakeQueue);
+	grid->sectors = NULL;
+	grid->wakeQueue = NULL;
+}
+
+void ClearSectors(SectorGrid* grid) {
+	if (!grid->sectors) return;
+
+	for (int i = 0; i < SECTORS_X * SECTORS_Y; ++i) {
+		Node* node = grid->sectors[i].head;
+		while (node != NULL) {
+			Node* next = node->next;
+			FreeNode(node);
+			node = next;
+		}
+
+		grid->sectors[i] = (Sector){NULL, 0, 0, -1, false};
+	}
+
+	grid->centerX = -1;
+	grid->centerY = -1;
+	grid->wakeCount = 0;
+	grid->focusSpeed = 0;
+}
+
+// Wraps a sector coordinate around the grid
+static int WrapIndex(int index, int count) {
+	index %= count;
+	return index < 0? index + count : index;
+}
+
+static Sector* GetSector(SectorGrid* grid, int x, int y) {
+	return &grid->sectors[WrapIndex(y, SECTORS_Y) * SECTORS_X + WrapIndex(x, SECTORS_X)];
+}
+
+static Sector* SectorAt(SectorGrid* grid, Vector2 pos) {
+	return GetSector(grid, floorf(pos.x / SECTOR_SIZE), floorf(pos.y / SECTOR_SIZE));
+}
+
+// returns: whether sector (x, y) is inside the active window, taking wrap-around into account
+static bool InActiveWindow(SectorGrid* grid, int x, int y) {
+	if (grid->centerX < 0) return false;
+
+	int dx = abs(WrapIndex(x, SECTORS_X) - grid->centerX);
+	int dy = abs(WrapIndex(y, SECTORS_Y) - grid->centerY);
+	if (SECTORS_X - dx < dx) dx = SECTORS_X - dx;
+	if (SECTORS_Y - dy < dy) dy = SECTORS_Y - dy;
+
+	return dx <= SECTOR_ACTIVE_RANGE && dy <= SECTOR_ACTIVE_RANGE;
+}
+
+bool IsPosActive(SectorGrid* grid, Vector2 pos) {
+	return SectorAt(grid, pos)->active;
+}
+
+// Wraps value into [min, max), same as wrapping it once per tick would
+static float WrapRange(float value, float min, float max) {
+	float size = max - min;
+	return value - size * floorf((value - min) / size);
+}
+
+void AdvanceObject(Object* obj, double deltaTime) {
+	obj->rot += obj->spin * deltaTime;
+	obj->pos = Vector2Add(obj->pos, Vector2Scale(obj->vel, deltaTime));
+
+	// Wrapping (objects wrap once they are fully outside of the area)
+	obj->pos.x = WrapRange(obj->pos.x, -obj->radius, AREA_W + obj->radius);
+	obj->pos.y = WrapRange(obj->pos.y, -obj->radius, AREA_H + obj->radius);
+}
+
+// Wake queue
+
+static double QueuedWakeTime(SectorGrid* grid, int index) {
+	return grid->sectors[grid->wakeQueue[index]].wakeTime;
+}
+
+// Puts a sector at index in the wake queue
+static void SetQueued(SectorGrid* grid, int index, int sectorIndex) {
+	grid->wakeQueue[index] = sectorIndex;
+	grid->sectors[sectorIndex].wakeIndex = index;
+}
+
+// Moves the sector at index towards the front of the queue until it's after its parent
+static void SiftUp(SectorGrid* grid, int index) {
+	int sectorIndex = grid->wakeQueue[index];
+	double wakeTime = grid->sectors[sectorIndex].wakeTime;
+
+	while (index > 0) {
+		int parent = (index - 1) / 2;
+		if (QueuedWakeTime(grid, parent) <= wakeTime) break;
+
+		SetQueued(grid, index, grid->wakeQueue[parent]);
+		index = parent;
+	}
+
+	SetQueued(grid, index, sectorIndex);
+}
+
+// Moves the sector at index towards the back of the queue until it's before its children
+static void SiftDown(SectorGrid* grid, int index) {
+	int sectorIndex = grid->wakeQueue[index];
+	double wakeTime = grid->sectors[sectorIndex].wakeTime;
+
+	while (2*index + 1 < grid->wakeCount) {
+		int child = 2*index + 1;
+		if (child + 1 < grid->wakeCount && QueuedWakeTime(grid, child + 1) < QueuedWakeTime(grid, child)) ++child;
+		if (QueuedWakeTime(grid, child) >= wakeTime) break;
+
+		SetQueued(grid, index, grid->wakeQueue[child]);
+		index = child;
+	}
+
+	SetQueued(grid, index, sectorIndex);
+}
+
+// Makes a sector wake up at wakeTime, or earlier if it already had to
+static void QueueSector(SectorGrid* grid, Sector* sector, double wakeTime) {
+	if (sector->wakeIndex < 0) {
+		sector->wakeTime = wakeTime;
+		SetQueued(grid, grid->wakeCount++, sector - grid->sectors);
+		SiftUp(grid, sector->wakeIndex);
+	} else if (wakeTime < sector->wakeTime) {
+		sector->wakeTime = wakeTime;
+		SiftUp(grid, sector->wakeIndex);
+	}
+}
+
+// returns: sector that wakes up first, taken out of the queue
+static Sector* PopSector(SectorGrid* grid) {
+	Sector* sector = &grid->sectors[grid->wakeQueue[0]];
+	sector->wakeIndex = -1;
+
+	if (--grid->wakeCount > 0) {
+		SetQueued(grid, 0, grid->wakeQueue[grid->wakeCount]);
+		SiftDown(grid, 0);
+	}
+
+	return sector;
+}
+//
+
+// returns: distance along an axis from the focus that a dormant object has to get under to be in the active window
+static float WakeDistance(Object* obj, float offset, int area, int sectors) {
+	// Sectors wrapping at the edge of the area can be smaller than the others
+	float reach = (SECTOR_ACTIVE_RANGE + 1) * SECTOR_SIZE + (sectors * SECTOR_SIZE - area);
+
+	// Objects wrap at their radius, so the distance can jump by their diameter
+	return fabsf(WrapRange(offset, -area/2.0f, area/2.0f)) - reach - SECTOR_WAKE_MARGIN - 2*obj->radius;
+}
+
+// returns: earliest time an object at time could be in the active window, however the focus moves
+static double WakeTime(SectorGrid* grid, Object* obj, double time) {
+	if (grid->centerX < 0) return time;
+
+	float distance = fmaxf(
+		WakeDistance(obj, obj->pos.x - grid->focus.x, AREA_W, SECTORS_X),
+		WakeDistance(obj, obj->pos.y - grid->focus.y, AREA_H, SECTORS_Y));
+	if (distance <= 0) return time;
+
+	// Both closing in along the axis they are farthest apart on, as fast as they can
+	return time + distance / (fmaxf(fabsf(obj->vel.x), fabsf(obj->vel.y)) + grid->focusSpeed);
+}
+
+// Stores a node that is in no list in the dormant sector containing it
+// time: simulation time the object is at
+static void BucketNode(SectorGrid* grid, Node* node, double time) {
+	Sector* sector = SectorAt(grid, node->obj->pos);
+	QueueSector(grid, sector, WakeTime(grid, node->obj, time));
+
+	// Rewinding the object so it is in sync with the other dormant objects of the sector
+	if (sector->head == NULL) sector->sleepTime = time;
+	else AdvanceObject(node->obj, sector->sleepTime - time);
+
+	InsertToList(node, &sector->head);
+}
+
+void SleepNode(SectorGrid* grid, Node* node, Node** head, double time) {
+	UnlinkNode(node, head);
+
+	// Objects with a lifetime are short-lived, so they are destroyed instead
+	if (node->obj->lifetime != NO_LIFETIME) {
+		FreeNode(node);
+		return;
+	}
+
+	// Compacting (transformed vertices are recalculated every tick when active)
+	free(node->obj->transVerts);
+	node->obj->transVerts = NULL;
+
+	BucketNode(grid, node, time);
+}
+
+void PlaceNode(SectorGrid* grid, Node* node, Node** head, double time) {
+	InsertToList(node, head);
+	if (!IsPosActive(grid, node->obj->pos)) SleepNode(grid, node, head, time);
+}
+
+// Advances the dormant objects of a sector to time, moving the ones now in an active sector to the list starting at head
+// and the others to the dormant sector they are now in
+static void RefreshSector(SectorGrid* grid, Sector* sector, Node** head, double time) {
+	if (sector->head == NULL) return;
+
+	Node* node = sector->head;
+	double sleepTime = sector->sleepTime;
+	sector->head = NULL;
+
+	while (node != NULL) {
+		Node* next = node->next;
+		Object* obj = node->obj;
+
+		AdvanceObject(obj, time - sleepTime);
+
+		if (IsPosActive(grid, obj->pos)) {
+			obj->transVerts = malloc(obj->vertCount * sizeof(Vector2));
+			InsertToList(node, head);
+		} else {
+			BucketNode(grid, node, time);
+		}
+
+		node = next;
+	}
+}
+
+// Moves the active window so it is centered on sector (x, y), waking the objects of the sectors entering it
+static void MoveWindow(SectorGrid* grid, int x, int y, Node** head, double time) {
+	int oldX = grid->centerX;
+	int oldY = grid->centerY;
+	grid->centerX = x;
+	grid->centerY = y;
+
+	// Sectors leaving the window go dormant (their objects are moved as they are processed)
+	if (oldX >= 0) {
+		for (int sy = oldY - SECTOR_ACTIVE_RANGE; sy <= oldY + SECTOR_ACTIVE_RANGE; ++sy) {
+			for (int sx = oldX - SECTOR_ACTIVE_RANGE; sx <= oldX + SECTOR_ACTIVE_RANGE; ++sx) {
+				Sector* sector = GetSector(grid, sx, sy);
+				if (InActiveWindow(grid, sx, sy)) continue;
+
+				sector->active = false;
+			}
+		}
+	}
+
+	// Sectors entering the window wake up (all of them are activated first, so objects that moved into another one wake up too)
+	for (int sy = y - SECTOR_ACTIVE_RANGE; sy <= y + SECTOR_ACTIVE_RANGE; ++sy) {
+		for (int sx = x - SECTOR_ACTIVE_RANGE; sx <= x + SECTOR_ACTIVE_RANGE; ++sx) {
+			Sector* sector = GetSector(grid, sx, sy);
+			if (sector->active) continue;
+
+			sector->active = true;
+		}
+	}
+
+	for (int sy = y - SECTOR_ACTIVE_RANGE; sy <= y + SECTOR_ACTIVE_RANGE; ++sy) {
+		for (int sx = x - SECTOR_ACTIVE_RANGE; sx <= x + SECTOR_ACTIVE_RANGE; ++sx) {
+			RefreshSector(grid, GetSector(grid, sx, sy), head, time); // Only the ones that just woke up have dormant objects
+		}
+	}
+}
+
+void UpdateActiveSectors(SectorGrid* grid, Vector2 pos, float maxSpeed, Node** head, double time) {
+	grid->focus = pos;
+	grid->focusSpeed = maxSpeed;
+
+	int x = WrapIndex(floorf(pos.x / SECTOR_SIZE), SECTORS_X);
+	int y = WrapIndex(floorf(pos.y / SECTOR_SIZE), SECTORS_Y);
+	if (x != grid->centerX || y != grid->centerY) MoveWindow(grid, x, y, head, time);
+
+	// Dormant sectors with objects that could have reached the window by now
+	// (objects close to it are checked every tick, the others only once they could have come close)
+	while (grid->wakeCount > 0 && QueuedWakeTime(grid, 0) < time) {
+		RefreshSector(grid, PopSector(grid), head, time);
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef SECTOR_H
+#define SECTOR_H
+
+#include <stdbool.h>
+#include <raylib.h>
+
+#include "object.h"
+
+// Playable area (can be overridden at compile time, e.g. -DAREA_W=100000)
+#ifndef AREA_W
+#define AREA_W 4000
+#endif
+#ifndef AREA_H
+#define AREA_H 4000
+#endif
+
+// Sectors
+#define SECTOR_SIZE 1000
+#define SECTOR_ACTIVE_RANGE 2 // Sectors around the player's one that are fully simulated
+#define SECTORS_X ((AREA_W + SECTOR_SIZE - 1) / SECTOR_SIZE)
+#define SECTORS_Y ((AREA_H + SECTOR_SIZE - 1) / SECTOR_SIZE)
+#define SECTOR_WAKE_MARGIN 64 // Pixels added to the distance objects must cover to reach the active window (the player wrapping and moving during a tick)
+
+// Square of the playfield holding its dormant objects
+typedef struct {
+	Node* head; // First element of list of dormant objects
+	double sleepTime; // Simulation time the dormant objects are at
+	double wakeTime; // Earliest time one of its objects could be in the active window
+	int wakeIndex; // Position in the wake queue, -1 when it isn't in it
+	bool active;
+} Sector;
+
+typedef struct {
+	Sector* sectors; // SECTORS_X * SECTORS_Y sectors, row by row
+	int centerX; // Sector in the middle of the active window, -1 when there is none
+	int centerY;
+
+	int* wakeQueue; // Indices of the dormant sectors with objects, as a min-heap on their wakeTime
+	int wakeCount;
+
+	Vector2 focus; // Position the active window is centered on
+	float focusSpeed; // Fastest focus can move
+} SectorGrid;
+
+void InitSectors(SectorGrid* grid);
+
+// Frees all dormant objects and the grid itself
+void FreeSectors(SectorGrid* grid);
+
+// Frees all dormant objects and makes every sector dormant
+void ClearSectors(SectorGrid* grid);
+
+// returns: whether the sector containing pos is fully simulated
+bool IsPosActive(SectorGrid* grid, Vector2 pos);
+
+// Moves object forward in time by deltaTime using its velocity and spin, wrapping it around the area
+void AdvanceObject(Object* obj, double deltaTime);
+
+// Unlinks Node node from list starting at Node head and stores it in the dormant sector containing it
+// time: simulation time the object is at
+void SleepNode(SectorGrid* grid, Node* node, Node** head, double time);
+
+// Adds a node that is in no list to the list starting at head if its sector is active, otherwise to its sector
+void PlaceNode(SectorGrid* grid, Node* node, Node** head, double time);
+
+// Centers the active window on the sector containing pos
+// Sectors leaving the window go dormant, and objects of sectors entering it are advanced to time and moved to the list starting at head
+// Dormant objects drifting into the window are also moved there (only sectors with objects that could have reached it are checked)
+// maxSpeed: fastest pos can move
+void UpdateActiveSectors(SectorGrid* grid, Vector2 pos, float maxSpeed, Node** head, double time);
+
+#endif
+
@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "game.h"
+
+// Checks that a player standing still in a large area keeps having asteroids around,
+// i.e. that dormant asteroids drifting into the active sectors wake up
+// usage: sectorcheck [seed] (built with a large area, see the sector-check target)
+
+#define CHECK_TICK (1.0/60)
+#define CHECK_TIME 120.0 // Simulated seconds
+#define CHECK_REPORT_SEC 20.0
+#define CHECK_MIN_FRACTION 0.5 // Fewest active asteroids allowed, as a fraction of the ones expected from the area
+
+// Counts the asteroids of the list starting at head
+int CountAsteroids(Node* head) {
+	int count = 0;
+	for (Node* node = head; node != NULL; node = node->next) {
+		count += node->obj->type == TYPE_ASTEROID;
+	}
+
+	return count;
+}
+
+int CountDormantAsteroids(GameContext* ctx) {
+	int count = 0;
+	for (int i = 0; i < SECTORS_X * SECTORS_Y; ++i) count += CountAsteroids(ctx->sectors.sectors[i].head);
+
+	return count;
+}
+
+// returns: fraction of the area covered by the active sectors
+double WindowFraction() {
+	int side = 2*SECTOR_ACTIVE_RANGE + 1;
+	double width  = side < SECTORS_X? side * SECTOR_SIZE : AREA_W;
+	double height = side < SECTORS_Y? side * SECTOR_SIZE : AREA_H;
+	return width / AREA_W * height / AREA_H;
+}
+
+int main(int argc, char** argv) {
+	uint64_t seed = argc > 1? strtoull(argv[1], NULL, 10) : 1;
+
+	GameContext ctx;
+	InitGame(&ctx, seed);
+
+	// Leaving the main menu
+	Process(&ctx, (GameInput){.play = true}, CHECK_TICK);
+
+	// Asteroids expected in the active sectors if they were spread evenly
+	double expected = (CountAsteroids(ctx.objs_head) + CountDormantAsteroids(&ctx)) * WindowFraction();
+
+	int lowest = -1;
+	double nextReport = 0;
+	while (ctx.simTime < CHECK_TIME) {
+		// Standing still and never dying
+		ctx.player->health = ctx.player->maxHealth;
+		Process(&ctx, (GameInput){0}, CHECK_TICK);
+
+		int active = CountAsteroids(ctx.objs_head);
+		if (ctx.simTime > CHECK_TIME/2 && (lowest == -1 || active < lowest)) lowest = active;
+
+		if (ctx.simTime >= nextReport) {
+			printf("time: %5.1fs, active asteroids: %d, dormant: %d\n", ctx.simTime, active, CountDormantAsteroids(&ctx));
+			nextReport += CHECK_REPORT_SEC;
+		}
+	}
+
+	FreeGame(&ctx);
+
+	// Checking over the second half, once the asteroids that started around the player had time to leave
+	bool passed = lowest >= expected * CHECK_MIN_FRACTION;
+	printf("lowest active asteroids: %d, expected: %.1f, %s\n", lowest, expected, passed? "ok" : "FAILED");
+
+	return passed? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
@@ -0,0 +1,118 @@
+#include <time.h>
+#include <signal.h>
+
+#include "simulation.h"
+
+// Input bits
+#define INPUT_SHOOT  1<<4
+#define INPUT_TURN_SHIFT   0 // turn+1, 2 bits
+#define INPUT_THRUST_SHIFT 2 // thrust+1, 2 bits
+
+double GetWallTime() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+static void SleepFor(double seconds) {
+	if (seconds <= 0) return;
+
+	struct timespec time = {seconds, (seconds - (long)seconds) * 1e9};
+	nanosleep(&time, NULL);
+}
+
+void SendInput(Simulation* sim, GameInput input) {
+	int packed = (input.turn + 1) << INPUT_TURN_SHIFT | (input.thrust + 1) << INPUT_THRUST_SHIFT;
+	if (input.shoot) packed |= INPUT_SHOOT;
+
+	atomic_store_explicit(&sim->input, packed, memory_order_relaxed);
+	if (input.play) atomic_store_explicit(&sim->play, true, memory_order_relaxed);
+}
+
+static GameInput TakeInput(Simulation* sim) {
+	int packed = atomic_load_explicit(&sim->input, memory_order_relaxed);
+
+	return (GameInput){
+		.turn   = (packed >> INPUT_TURN_SHIFT & 3) - 1,
+		.thrust = (packed >> INPUT_THRUST_SHIFT & 3) - 1,
+		.shoot  = packed & INPUT_SHOOT,
+		.play   = atomic_exchange_explicit(&sim->play, false, memory_order_relaxed),
+	};
+}
+
+void ReportFrameTime(Simulation* sim, float frameTime) {
+	int frameUs = frameTime * 1e6;
+	int longest = atomic_load_explicit(&sim->frameSpikeUs, memory_order_relaxed);
+	while (frameUs > longest && !atomic_compare_exchange_weak_explicit(&sim->frameSpikeUs, &longest, frameUs, memory_order_relaxed, memory_order_relaxed));
+}
+
+static void Tick(Simulation* sim) {
+	GameContext* game = &sim->game;
+
+	// Logging the render spikes here, since the event log only takes events from one thread
+	int spikeUs = atomic_exchange_explicit(&sim->frameSpikeUs, 0, memory_order_relaxed);
+	if (spikeUs > FRAME_SPIKE_SEC * 1e6) {
+		LogEvent(game->eventLog, (Event){.type = EVENT_FRAME_SPIKE, .time = game->simTime, .duration = spikeUs / 1e6});
+	}
+
+	double start = GetWallTime();
+	Process(game, TakeInput(sim), SIM_TICK);
+	AddTimingSample(&sim->tickStats, GetWallTime() - start);
+}
+
+static void* SimulationThread(void* arg) {
+	Simulation* sim = arg;
+
+	double previous = GetWallTime();
+	double accumulator = 0;
+	while (atomic_load_explicit(&sim->running, memory_order_relaxed)) {
+		double now = GetWallTime();
+		accumulator += now - previous;
+		previous = now;
+
+		// After a stall (e.g. generating a big level), catching up only so far
+		if (accumulator > SIM_MAX_CATCHUP) accumulator = SIM_MAX_CATCHUP;
+
+		bool ticked = false;
+		while (accumulator >= SIM_TICK) {
+			Tick(sim);
+			accumulator -= SIM_TICK;
+			ticked = true;
+		}
+
+		if (ticked) {
+			RenderSnapshot* snapshot = GetBackSnapshot(&sim->snapshots);
+			WriteSnapshot(snapshot, &sim->game, GetWallTime());
+			snapshot->tickStats = sim->tickStats;
+			PublishSnapshot(&sim->snapshots);
+		}
+
+		SleepFor(SIM_TICK - accumulator);
+	}
+
+	return NULL;
+}
+
+void StartSimulation(Simulation* sim) {
+	atomic_init(&sim->input, 0);
+	atomic_init(&sim->play, false);
+	SendInput(sim, (GameInput){0});
+	atomic_init(&sim->frameSpikeUs, 0);
+	atomic_init(&sim->running, true);
+	sim->tickStats = (TimingStats){0};
+
+	// Blocking SIGINT in the thread, so it's handled by the main thread
+	sigset_t block, previous;
+	sigemptyset(&block);
+	sigaddset(&block, SIGINT);
+	pthread_sigmask(SIG_BLOCK, &block, &previous);
+	pthread_create(&sim->thread, NULL, SimulationThread, sim);
+	pthread_sigmask(SIG_SETMASK, &previous, NULL);
+}
+
+void StopSimulation(Simulation* sim) {
+	if (!atomic_exchange(&sim->running, false)) return;
+
+	pthread_join(sim->thread, NULL);
+}
+
@@ -0,0 +1,46 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "game.h"
+#include "snapshot.h"
+
+#define SIM_TICK (1.0/120) // Fixed delta time of every tick
+#define SIM_MAX_CATCHUP 0.25 // Most time simulated at once after a stall, the rest is dropped
+#define FRAME_SPIKE_SEC 0.05 // Render frames longer than this are logged
+
+// Game running on its own thread, publishing a snapshot after each batch of ticks
+typedef struct {
+	GameContext game; // Only touched by the simulation thread once it started
+	TripleBuffer snapshots;
+
+	// From the renderer
+	atomic_int input; // Packed GameInput, without play
+	atomic_bool play; // Set by the renderer, cleared when the simulation uses it
+	atomic_int frameSpikeUs; // Longest render frame since the last tick, in microseconds
+
+	atomic_bool running;
+	pthread_t thread;
+
+	TimingStats tickStats;
+} Simulation;
+
+// returns: monotonic time in seconds, the same for both threads
+double GetWallTime();
+
+// Starts the simulation thread (the game must already be initialized)
+void StartSimulation(Simulation* sim);
+
+// Stops and waits for the simulation thread
+void StopSimulation(Simulation* sim);
+
+void SendInput(Simulation* sim, GameInput input);
+
+// Hands a render frame time to the simulation, which logs it if it's a spike
+void ReportFrameTime(Simulation* sim, float frameTime);
+
+#endif
+
@@ -0,0 +1,180 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "snapshot.h"
+
+#define SNAPSHOT_FRESH 4 // Set on the middle buffer index when it has a snapshot the renderer didn't take
+#define SNAPSHOT_INDEX 3
+#define TIMING_SMOOTHING 0.05 // Weight of a new sample in the moving averages
+
+void InitTripleBuffer(TripleBuffer* buffer) {
+	memset(buffer->buffers, 0, sizeof(buffer->buffers));
+	buffer->buffers[0].inMenu = true;
+	buffer->buffers[1].inMenu = true;
+	buffer->buffers[2].inMenu = true;
+
+	buffer->back = 0;
+	atomic_init(&buffer->middle, 1);
+	buffer->front = 2;
+}
+
+void FreeTripleBuffer(TripleBuffer* buffer) {
+	for (int i = 0; i < 3; ++i) {
+		free(buffer->buffers[i].objects);
+		free(buffer->buffers[i].vertices);
+		free(buffer->buffers[i].bursts);
+	}
+
+	memset(buffer->buffers, 0, sizeof(buffer->buffers));
+}
+
+RenderSnapshot* GetBackSnapshot(TripleBuffer* buffer) {
+	return &buffer->buffers[buffer->back];
+}
+
+RenderSnapshot* GetFrontSnapshot(TripleBuffer* buffer) {
+	return &buffer->buffers[buffer->front];
+}
+
+// Grows array (of elements of size size) so it fits at least count elements
+static void Reserve(void** array, int* capacity, int count, size_t size) {
+	if (count <= *capacity) return;
+
+	while (*capacity < count) *capacity = *capacity? *capacity * 2 : 64;
+	*array = realloc(*array, *capacity * size);
+}
+
+void WriteSnapshot(RenderSnapshot* snapshot, GameContext* ctx, double publishTime) {
+	snapshot->simTime = ctx->simTime;
+	snapshot->publishTime = publishTime;
+
+	// HUD
+	snapshot->inMenu = ctx->player == NULL;
+	snapshot->level = ctx->level;
+	snapshot->highscore = ctx->highscore;
+	snapshot->health = ctx->player? ctx->player->health : 0;
+
+	snapshot->cameraTarget = ctx->camera.target;
+
+	// Objects
+	snapshot->objectCount = 0;
+	snapshot->vertCount = 0;
+	for (Node* node = ctx->objs_head; node != NULL; node = node->next) {
+		Object* obj = node->obj;
+
+		Reserve((void**)&snapshot->objects, &snapshot->objectCapacity, snapshot->objectCount + 1, sizeof(SnapshotObject));
+		Reserve((void**)&snapshot->vertices, &snapshot->vertCapacity, snapshot->vertCount + obj->vertCount, sizeof(Vector2));
+
+		snapshot->objects[snapshot->objectCount++] = (SnapshotObject){
+			.id = obj->id,
+			.type = obj->type,
+			.pos = obj->pos,
+			.rot = obj->rot,
+			.radius = obj->radius,
+			.color = obj->color,
+			.firstVert = snapshot->vertCount,
+			.vertCount = obj->vertCount,
+		};
+
+		memcpy(&snapshot->vertices[snapshot->vertCount], obj->vertices, obj->vertCount * sizeof(Vector2));
+		snapshot->vertCount += obj->vertCount;
+	}
+
+	// Moving the particle bursts (there may be some left from a snapshot the renderer skipped)
+	if (ctx->burstCount == 0) return;
+	Reserve((void**)&snapshot->bursts, &snapshot->burstCapacity, snapshot->burstCount + ctx->burstCount, sizeof(ParticleBurst));
+	memcpy(&snapshot->bursts[snapshot->burstCount], ctx->bursts, ctx->burstCount * sizeof(ParticleBurst));
+	snapshot->burstCount += ctx->burstCount;
+	ctx->burstCount = 0;
+}
+
+void PublishSnapshot(TripleBuffer* buffer) {
+	int old = atomic_exchange_explicit(&buffer->middle, buffer->back | SNAPSHOT_FRESH, memory_order_acq_rel);
+	buffer->back = old & SNAPSHOT_INDEX;
+
+	// The renderer took it, so its bursts were emitted
+	if (!(old & SNAPSHOT_FRESH)) buffer->buffers[buffer->back].burstCount = 0;
+}
+
+// Hash for the id table (ids are sequential, so spreading them out avoids long probe chains)
+static unsigned int HashId(unsigned int id) {
+	return id * 2654435761u;
+}
+
+// Remembers the positions of snapshot before it is given back to the simulation
+static void KeepSnapshot(PreviousSnapshot* prev, RenderSnapshot* snapshot) {
+	prev->simTime = snapshot->simTime;
+	prev->cameraTarget = snapshot->cameraTarget;
+
+	// Copying the positions
+	if (snapshot->objectCount > prev->capacity) {
+		prev->capacity = snapshot->objectCount * 2;
+		prev->ids = realloc(prev->ids, prev->capacity * sizeof(unsigned int));
+		prev->pos = realloc(prev->pos, prev->capacity * sizeof(Vector2));
+		prev->rot = realloc(prev->rot, prev->capacity * sizeof(float));
+	}
+
+	prev->count = snapshot->objectCount;
+	for (int i = 0; i < prev->count; ++i) {
+		prev->ids[i] = snapshot->objects[i].id;
+		prev->pos[i] = snapshot->objects[i].pos;
+		prev->rot[i] = snapshot->objects[i].rot;
+	}
+
+	// Building the id table (at most half full)
+	int tableSize = 64;
+	while (tableSize < prev->count * 2) tableSize *= 2;
+	if (tableSize != prev->tableSize) {
+		prev->tableSize = tableSize;
+		prev->table = realloc(prev->table, tableSize * sizeof(int));
+	}
+
+	for (int i = 0; i < tableSize; ++i) prev->table[i] = -1;
+	for (int i = 0; i < prev->count; ++i) {
+		unsigned int slot = HashId(prev->ids[i]) & (tableSize - 1);
+		while (prev->table[slot] != -1) slot = (slot + 1) & (tableSize - 1);
+		prev->table[slot] = i;
+	}
+}
+
+bool AcquireSnapshot(TripleBuffer* buffer, PreviousSnapshot* prev) {
+	if (!(atomic_load_explicit(&buffer->middle, memory_order_relaxed) & SNAPSHOT_FRESH)) return false;
+
+	KeepSnapshot(prev, GetFrontSnapshot(buffer));
+
+	int old = atomic_exchange_explicit(&buffer->middle, buffer->front, memory_order_acq_rel);
+	buffer->front = old & SNAPSHOT_INDEX;
+	return true;
+}
+
+void FreePreviousSnapshot(PreviousSnapshot* prev) {
+	free(prev->ids);
+	free(prev->pos);
+	free(prev->rot);
+	free(prev->table);
+	*prev = (PreviousSnapshot){0};
+}
+
+int FindPrevious(PreviousSnapshot* prev, unsigned int id) {
+	if (prev->tableSize == 0) return -1;
+
+	unsigned int slot = HashId(id) & (prev->tableSize - 1);
+	while (prev->table[slot] != -1) {
+		if (prev->ids[prev->table[slot]] == id) return prev->table[slot];
+		slot = (slot + 1) & (prev->tableSize - 1);
+	}
+
+	return -1;
+}
+
+void AddTimingSample(TimingStats* stats, double sample) {
+	double diff = sample - stats->mean;
+	stats->mean += diff * TIMING_SMOOTHING;
+	stats->variance += (diff*diff - stats->variance) * TIMING_SMOOTHING;
+}
+
+double GetJitter(TimingStats stats) {
+	return sqrt(stats.variance);
+}
+
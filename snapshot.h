@@ -0,0 +1,113 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <raylib.h>
+
+#include "game.h"
+#include "particles.h"
+
+// Object as the render thread sees it
+typedef struct {
+	unsigned int id;
+	int type;
+	Vector2 pos;
+	float rot;
+	int radius;
+	Color color;
+	int firstVert; // Index of its first vertex in the snapshot's vertices
+	int vertCount;
+} SnapshotObject;
+
+// Exponential moving average of a duration and of its variance
+typedef struct {
+	double mean;
+	double variance;
+} TimingStats;
+
+// Immutable copy of everything needed to draw a tick, written by the simulation and read by the renderer
+typedef struct {
+	double simTime;
+	double publishTime; // Wall time it was published, for measuring latency
+
+	// HUD
+	bool inMenu;
+	int level;
+	int highscore;
+	int health;
+
+	Vector2 cameraTarget;
+
+	SnapshotObject* objects;
+	int objectCount;
+	int objectCapacity;
+
+	Vector2* vertices; // Untransformed vertices of all objects
+	int vertCount;
+	int vertCapacity;
+
+	// Particles emitted since the last snapshot the renderer took
+	ParticleBurst* bursts;
+	int burstCount;
+	int burstCapacity;
+
+	TimingStats tickStats; // Time the simulation takes per tick
+} RenderSnapshot;
+
+// Lock-free triple buffer: the simulation always has a back buffer to write and the renderer a front buffer to read
+typedef struct {
+	RenderSnapshot buffers[3];
+	atomic_int middle; // Buffer between the two, with SNAPSHOT_FRESH set when it wasn't taken yet
+	int back; // Only used by the simulation
+	int front; // Only used by the renderer
+} TripleBuffer;
+
+// Positions of the previous snapshot, kept by the renderer to interpolate from
+typedef struct {
+	double simTime;
+	Vector2 cameraTarget;
+
+	unsigned int* ids;
+	Vector2* pos;
+	float* rot;
+	int count;
+	int capacity;
+
+	int* table; // Open addressing table from id to index
+	int tableSize;
+} PreviousSnapshot;
+
+void InitTripleBuffer(TripleBuffer* buffer);
+
+void FreeTripleBuffer(TripleBuffer* buffer);
+
+// returns: back buffer, the one the simulation writes to
+RenderSnapshot* GetBackSnapshot(TripleBuffer* buffer);
+
+// Copies the state of the game to the back buffer, moving the game's particle bursts to it
+void WriteSnapshot(RenderSnapshot* snapshot, GameContext* ctx, double publishTime);
+
+// Makes the back buffer available to the renderer
+// If the renderer skipped the buffer returned as the new back buffer, its particle bursts are kept for the next snapshot
+void PublishSnapshot(TripleBuffer* buffer);
+
+// Takes the latest snapshot if there is a new one, keeping the positions of the current one in prev
+// returns: whether the front buffer changed
+bool AcquireSnapshot(TripleBuffer* buffer, PreviousSnapshot* prev);
+
+// returns: front buffer, the one the renderer reads
+RenderSnapshot* GetFrontSnapshot(TripleBuffer* buffer);
+
+void FreePreviousSnapshot(PreviousSnapshot* prev);
+
+// returns: index of the object with id in prev, -1 if it isn't there
+int FindPrevious(PreviousSnapshot* prev, unsigned int id);
+
+void AddTimingSample(TimingStats* stats, double sample);
+
+// returns: standard deviation of the samples
+double GetJitter(TimingStats stats);
+
+#endif
+